@@ -0,0 +1,630 @@
+﻿// MousePathCore.h
+// Bounded-memory summaries, sliding windows and alert rules, synthetic-motion
+// and Fitts movement detection, the tremor filter bank, the screen-zone grid,
+// the daily history index, the host aggregator's fold, the dwell heatmap
+// pyramid and the graph decimation used by MousePathTracker.cpp, kept free of
+// Win32 so tests/CoreCheck.cpp can build and measure them on any compiler.
+//
+// Programmer: Bob Paydar
+//
+// © 2025 Bob Paydar. MIT License.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cwchar>
+
+// Window titles
+inline unsigned long long TitleHash(const wchar_t* s) {
+    unsigned long long h = 14695981039346656037ULL; // FNV-1a, then a mixer so the top bits are usable
+    for (; *s; ++s) { h ^= (unsigned long long)*s; h *= 1099511628211ULL; }
+    h ^= h >> 33; h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33; h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// HyperLogLog over 2^bits one-byte registers; the standard error is about
+// 1.04 / sqrt(2^bits). Sketches with the same bits merge register by register.
+inline void HllAdd(unsigned char* registers, unsigned bits, unsigned long long h) {
+    unsigned index = (unsigned)(h >> (64 - bits));
+    unsigned long long rest = h << bits;
+    unsigned char rank = 1;
+    while (rank <= 64 - bits && !(rest & 0x8000000000000000ULL)) { ++rank; rest <<= 1; }
+    if (rank > registers[index]) registers[index] = rank;
+}
+
+inline double HllEstimate(const unsigned char* registers, unsigned bits) {
+    const unsigned count = 1u << bits;
+    const double m = count;
+    double sum = 0.0;
+    unsigned zeros = 0;
+    for (unsigned i = 0; i < count; ++i) {
+        sum += std::ldexp(1.0, -(int)registers[i]);
+        if (!registers[i]) ++zeros;
+    }
+    double estimate = 0.7213 / (1.0 + 1.079 / m) * m * m / sum;
+    if (estimate <= 2.5 * m && zeros) estimate = m * std::log(m / zeros); // linear counting for small sets
+    return estimate;
+}
+
+inline void HllMerge(unsigned char* into, const unsigned char* from, unsigned bits) {
+    for (unsigned i = 0; i < (1u << bits); ++i)
+        if (from[i] > into[i]) into[i] = from[i];
+}
+
+// Space-Saving summary: with capacity counters, any title holding more than
+// 1/capacity of the total weight is guaranteed a counter, and mm - errMM <=
+// true weight <= mm for every counter.
+struct TitleCounter {
+    wchar_t title[96];
+    double mm;
+    double errMM;
+};
+
+// A title without a counter takes over the smallest one and inherits its
+// count as error. Titles longer than the buffer are truncated.
+inline void SpaceSavingAdd(TitleCounter* counters, unsigned& count, unsigned capacity, const wchar_t* title, double mm) {
+    unsigned slot = count, least = 0;
+    for (unsigned i = 0; i < count; ++i) {
+        if (std::wcscmp(counters[i].title, title) == 0) { slot = i; break; }
+        if (counters[i].mm < counters[least].mm) least = i;
+    }
+    if (slot == count) {
+        if (count < capacity) {
+            slot = count++;
+            counters[slot] = TitleCounter{};
+        }
+        else {
+            slot = least;
+            counters[slot].errMM = counters[slot].mm;
+        }
+        const size_t room = sizeof(counters[slot].title) / sizeof(wchar_t);
+        size_t n = 0;
+        for (; n + 1 < room && title[n]; ++n) counters[slot].title[n] = title[n];
+        counters[slot].title[n] = L'\0';
+    }
+    counters[slot].mm += mm;
+}
+
+// Graph
+// Largest-Triangle-Three-Buckets over an evenly spaced series. Keeps the first
+// and last points and, from each of the threshold - 2 buckets between them,
+// the point spanning the largest triangle with the previous pick and the
+// average of the next bucket. One pass, no allocation.
+inline unsigned Lttb(const double* y, unsigned n, unsigned threshold, unsigned* picked) {
+    if (threshold >= n || threshold < 3) {
+        for (unsigned i = 0; i < n; ++i) picked[i] = i;
+        return n;
+    }
+    double every = (double)(n - 2) / (threshold - 2);
+    unsigned a = 0, count = 0;
+    picked[count++] = 0;
+    for (unsigned b = 0; b < threshold - 2; ++b) {
+        unsigned avgStart = (unsigned)((b + 1) * every) + 1;
+        unsigned avgEnd = (unsigned)((b + 2) * every) + 1;
+        if (avgEnd > n) avgEnd = n;
+        double avgX = 0.0, avgY = 0.0;
+        for (unsigned j = avgStart; j < avgEnd; ++j) { avgX += j; avgY += y[j]; }
+        avgX /= (avgEnd - avgStart);
+        avgY /= (avgEnd - avgStart);
+
+        unsigned start = (unsigned)(b * every) + 1, end = (unsigned)((b + 1) * every) + 1;
+        double best = -1.0;
+        unsigned next = start;
+        for (unsigned j = start; j < end; ++j) {
+            double area = std::fabs(((double)a - avgX) * (y[j] - y[a]) - ((double)a - j) * (avgY - y[a]));
+            if (area > best) { best = area; next = j; }
+        }
+        picked[count++] = next;
+        a = next;
+    }
+    picked[count++] = n - 1;
+    return count;
+}
+
+// Heatmap pyramid
+// Level 0 is a w x h grid; each level above sums 2x2 cells of the one below
+// (an odd edge cell covers what is left) until one cell remains. All levels
+// sit in one row-major array, level 0 first. An add touches one cell per
+// level; a query reads only the cells it returns.
+constexpr unsigned PyramidSide(unsigned cells, unsigned level) { return (cells + (1u << level) - 1) >> level; }
+constexpr unsigned PyramidOffset(unsigned w, unsigned h, unsigned level) {
+    return level == 0 ? 0 : PyramidOffset(w, h, level - 1) + PyramidSide(w, level - 1) * PyramidSide(h, level - 1);
+}
+
+inline void PyramidAdd(double* cells, unsigned w, unsigned h, unsigned levels, unsigned x, unsigned y, double v) {
+    for (unsigned l = 0; l < levels; ++l, x >>= 1, y >>= 1)
+        cells[PyramidOffset(w, h, l) + y * PyramidSide(w, l) + x] += v;
+}
+
+// Copies cells [x0, x1) x [y0, y1) of one level into out, row by row; the
+// rectangle is clipped to the level. Returns the number of cells copied.
+inline unsigned PyramidQuery(const double* cells, unsigned w, unsigned h, unsigned levels, unsigned level,
+    unsigned x0, unsigned y0, unsigned x1, unsigned y1, double* out) {
+    if (level >= levels) return 0;
+    const unsigned lw = PyramidSide(w, level), base = PyramidOffset(w, h, level);
+    if (x1 > lw) x1 = lw;
+    if (y1 > PyramidSide(h, level)) y1 = PyramidSide(h, level);
+    unsigned n = 0;
+    for (unsigned y = y0; y < y1; ++y)
+        for (unsigned x = x0; x < x1; ++x) out[n++] = cells[base + y * lw + x];
+    return n;
+}
+
+// Heaviest cell of one level, by scanning it. A sum pyramid cannot be
+// descended greedily: a parent of four light cells can outweigh one holding
+// a single heavy cell. False when the pyramid is empty.
+inline bool PyramidBusiest(const double* cells, unsigned w, unsigned h, unsigned levels, unsigned level,
+    unsigned* x, unsigned* y) {
+    if (level >= levels || cells[PyramidOffset(w, h, levels - 1)] <= 0.0) return false;
+    const unsigned lw = PyramidSide(w, level), lh = PyramidSide(h, level), base = PyramidOffset(w, h, level);
+    double best = -1.0;
+    for (unsigned cy = 0; cy < lh; ++cy) {
+        for (unsigned cx = 0; cx < lw; ++cx) {
+            if (cells[base + cy * lw + cx] > best) { best = cells[base + cy * lw + cx]; *x = cx; *y = cy; }
+        }
+    }
+    return true;
+}
+
+// Sliding windows
+// A ring of equal buckets plus a running sum, moved along by a millisecond
+// clock. Buckets that fell out of the window since the last call are
+// subtracted and cleared, so the cost of an add does not depend on the
+// window length.
+enum : unsigned { WINDOW_BUCKETS = 60 };
+struct SlidingWindow {
+    unsigned long long bucketMs;
+    unsigned buckets;            // <= WINDOW_BUCKETS; window = buckets * bucketMs
+    unsigned long long newest;   // absolute bucket number (clock / bucketMs)
+    double sum;
+    double bucket[WINDOW_BUCKETS];
+};
+
+inline void WindowAdvance(SlidingWindow& w, unsigned long long nowMs) {
+    unsigned long long b = nowMs / w.bucketMs;
+    if (b == w.newest) return;
+    if (b < w.newest || b - w.newest >= w.buckets) {
+        for (unsigned i = 0; i < w.buckets; ++i) w.bucket[i] = 0.0;
+        w.sum = 0.0;
+    }
+    else {
+        for (unsigned long long i = w.newest + 1; i <= b; ++i) {
+            double& slot = w.bucket[i % w.buckets];
+            w.sum -= slot;
+            slot = 0.0;
+        }
+    }
+    w.newest = b;
+}
+
+inline void WindowAdd(SlidingWindow& w, unsigned long long nowMs, double v) {
+    WindowAdvance(w, nowMs);
+    w.bucket[w.newest % w.buckets] += v;
+    w.sum += v;
+}
+
+inline double WindowSum(SlidingWindow& w, unsigned long long nowMs) {
+    WindowAdvance(w, nowMs);
+    return w.sum > 0.0 ? w.sum : 0.0; // running subtraction can leave a tiny negative residue
+}
+
+// Alerts
+// Two rules over a millisecond clock: distance in a rolling hour, and
+// continuous activity without a break. Each fires at most once per
+// repeatMinutes; a rule set to 0 is off.
+struct AlertRules {
+    unsigned hourlyMeters;
+    unsigned noBreakMinutes;
+    unsigned breakMinutes;       // idle time that counts as a break, >= 1
+    unsigned repeatMinutes;      // >= 1
+};
+struct AlertState {
+    unsigned long long lastActiveMs;
+    unsigned long long activeSinceMs;
+    unsigned long long hourlyFiredMs, noBreakFiredMs;   // 0: never fired
+};
+enum : unsigned { ALERT_HOURLY = 1, ALERT_NO_BREAK = 2 };
+
+// Records movement at nowMs; an idle gap of breakMinutes starts a new run.
+inline void AlertActivity(const AlertRules& rules, AlertState& s, unsigned long long nowMs) {
+    if (!s.activeSinceMs || nowMs - s.lastActiveMs >= rules.breakMinutes * 60000ULL) s.activeSinceMs = nowMs;
+    s.lastActiveMs = nowMs;
+}
+
+// Returns the ALERT_ bits of the rules that fire at nowMs, with the hour's
+// meters and the current run's minutes for the messages. hourMM is the
+// distance window the hourly rule reads.
+inline unsigned AlertCheck(const AlertRules& rules, AlertState& s, SlidingWindow& hourMM, unsigned long long nowMs,
+    double* meters, unsigned long long* activeMin) {
+    const unsigned long long repeatMs = rules.repeatMinutes * 60000ULL;
+    unsigned fired = 0;
+    if (rules.hourlyMeters && (!s.hourlyFiredMs || nowMs - s.hourlyFiredMs >= repeatMs)) {
+        *meters = WindowSum(hourMM, nowMs) / 1000.0;
+        if (*meters > rules.hourlyMeters) {
+            s.hourlyFiredMs = nowMs;
+            fired |= ALERT_HOURLY;
+        }
+    }
+    if (rules.noBreakMinutes && s.activeSinceMs && (!s.noBreakFiredMs || nowMs - s.noBreakFiredMs >= repeatMs)) {
+        bool onBreak = nowMs - s.lastActiveMs >= rules.breakMinutes * 60000ULL;
+        *activeMin = (s.lastActiveMs - s.activeSinceMs) / 60000;
+        if (!onBreak && *activeMin >= rules.noBreakMinutes) {
+            s.noBreakFiredMs = nowMs;
+            fired |= ALERT_NO_BREAK;
+        }
+    }
+    return fired;
+}
+
+// Fitts
+// Each movement between two left-button presses is measured with constant
+// state: start, path length and farthest excursion. Throughput uses a
+// nominal target width, since the real targets are unknown.
+enum : unsigned { FITTS_MIN_PX = 20, FITTS_MAX_MS = 5000 };
+struct FittsMovement {
+    double distancePx;      // start to click, straight line
+    double pathPx;          // distance actually travelled
+    double overshootPx;     // farthest excursion beyond the click distance
+    unsigned ms;
+};
+struct FittsStats {
+    double count;
+    double sumTP;           // bits/s
+    double sumEfficiency;   // straight / path
+    double sumOvershootPx;
+    double sumMs;
+};
+struct FittsTracker {
+    long startX, startY;
+    unsigned startTime;     // millisecond clock of the press; wraps
+    double pathPx;
+    double maxDist2;
+    bool armed;             // false until the first press
+};
+
+// Constant work per move; px is the length of the step that ended at x, y.
+inline void FittsTrackMove(FittsTracker& t, long x, long y, double px) {
+    t.pathPx += px;
+    double dx = (double)(x - t.startX), dy = (double)(y - t.startY);
+    double d2 = dx * dx + dy * dy;
+    if (d2 > t.maxDist2) t.maxDist2 = d2;
+}
+
+// Closes the movement that ends at this press into *m and starts the next
+// one. False when there was no movement or it was not an aimed one: short
+// hops (double clicks) and slow wandering are left out.
+inline bool FittsTrackClick(FittsTracker& t, long x, long y, unsigned time, FittsMovement* m) {
+    bool aimed = false;
+    if (t.armed) {
+        double dx = (double)(x - t.startX), dy = (double)(y - t.startY);
+        double d = std::sqrt(dx * dx + dy * dy);
+        unsigned ms = time - t.startTime;
+        if (d >= FITTS_MIN_PX && ms > 0 && ms <= FITTS_MAX_MS && t.pathPx >= d) {
+            m->distancePx = d;
+            m->pathPx = t.pathPx;
+            double farthest = std::sqrt(t.maxDist2);
+            m->overshootPx = farthest > d ? farthest - d : 0.0;
+            m->ms = ms;
+            aimed = true;
+        }
+    }
+    t.startX = x;
+    t.startY = y;
+    t.startTime = time;
+    t.pathPx = 0.0;
+    t.maxDist2 = 0.0;
+    t.armed = true;
+    return aimed;
+}
+
+inline void FittsAdd(FittsStats& s, const FittsMovement& m, double targetPx) {
+    double id = std::log2(m.distancePx / targetPx + 1.0);
+    s.count += 1.0;
+    s.sumTP += id / (m.ms / 1000.0);
+    s.sumEfficiency += m.distancePx / m.pathPx;
+    s.sumOvershootPx += m.overshootPx;
+    s.sumMs += m.ms;
+}
+
+// Synthetic movement
+// Macro players and remote control repeat the exact same step at the same
+// interval; a hand never does for long. Slow hand motion can repeat a
+// one-pixel step, so only steps of SYNTH_MIN_STEP px or more count towards a
+// run.
+enum : unsigned { SYNTH_RUN_STEPS = 16, SYNTH_MIN_STEP = 3 };
+struct SynthRun {
+    long stepX, stepY;
+    long long interval;     // clock ticks between the run's first two steps
+    unsigned steps;
+};
+
+// A few compares per move. True once SYNTH_RUN_STEPS steps in a row have had
+// the same vector and an interval within tolerance ticks of the run's first.
+inline bool SynthStep(SynthRun& r, long dx, long dy, long long interval, long long tolerance) {
+    long ax = dx < 0 ? -dx : dx, ay = dy < 0 ? -dy : dy;
+    long long drift = interval - r.interval;
+    if ((ax > ay ? ax : ay) >= (long)SYNTH_MIN_STEP && dx == r.stepX && dy == r.stepY && (drift < 0 ? -drift : drift) <= tolerance) {
+        if (r.steps < SYNTH_RUN_STEPS) ++r.steps;
+    }
+    else {
+        r.steps = 0;
+        r.stepX = dx;
+        r.stepY = dy;
+        r.interval = interval;
+    }
+    return r.steps >= SYNTH_RUN_STEPS;
+}
+
+// Zones
+// User-defined rectangles, right and bottom exclusive. A uniform grid over the
+// screen lists the zones overlapping each cell in CSR form (per-cell start
+// offsets into one list), so a lookup only tests the few candidates of one
+// cell.
+enum : unsigned { ZONE_GRID = 64, ZONE_GRID_ENTRIES = 32768 };
+struct ZoneRect {
+    long left, top, right, bottom;
+};
+struct Zone {
+    wchar_t name[32];
+    ZoneRect rc;
+    double mm;
+    double ms;
+};
+struct ZoneGrid {
+    ZoneRect screen;
+    long cellW, cellH;
+    unsigned zones;                                     // zones [0, zones) are in the grid
+    unsigned cellStart[ZONE_GRID * ZONE_GRID + 1];
+    unsigned short cellList[ZONE_GRID_ENTRIES];
+};
+
+// Two passes over the zones (count, then fill). Zones from the first one that
+// would overflow the entry table on are left out of the grid.
+inline void ZoneGridBuild(ZoneGrid& g, const Zone* zones, unsigned count, const ZoneRect& screen) {
+    g.screen = screen;
+    g.cellW = (screen.right - screen.left + ZONE_GRID - 1) / ZONE_GRID;
+    g.cellH = (screen.bottom - screen.top + ZONE_GRID - 1) / ZONE_GRID;
+    if (g.cellW < 1) g.cellW = 1;
+    if (g.cellH < 1) g.cellH = 1;
+
+    for (unsigned c = 0; c <= ZONE_GRID * ZONE_GRID; ++c) g.cellStart[c] = 0;
+    unsigned gridZones = count, entries = 0;
+    for (int pass = 0; pass < 2; ++pass) {
+        for (unsigned i = 0; i < gridZones; ++i) {
+            const ZoneRect& rc = zones[i].rc;
+            long x0 = (rc.left - screen.left) / g.cellW, y0 = (rc.top - screen.top) / g.cellH;
+            long x1 = (rc.right - 1 - screen.left) / g.cellW, y1 = (rc.bottom - 1 - screen.top) / g.cellH;
+            if (x0 < 0) x0 = 0;
+            if (y0 < 0) y0 = 0;
+            if (x1 > (long)ZONE_GRID - 1) x1 = ZONE_GRID - 1;
+            if (y1 > (long)ZONE_GRID - 1) y1 = ZONE_GRID - 1;
+            if (x1 < x0 || y1 < y0) continue;
+            if (pass == 0) {
+                unsigned cells = (unsigned)((x1 - x0 + 1) * (y1 - y0 + 1));
+                if (entries + cells > ZONE_GRID_ENTRIES) { gridZones = i; break; }
+                entries += cells;
+            }
+            for (long y = y0; y <= y1; ++y) {
+                for (long x = x0; x <= x1; ++x) {
+                    unsigned c = (unsigned)(y * ZONE_GRID + x);
+                    if (pass == 0) ++g.cellStart[c + 1];
+                    else g.cellList[g.cellStart[c]++] = (unsigned short)i; // start doubles as write cursor
+                }
+            }
+        }
+        if (pass == 0)
+            for (unsigned c = 0; c < ZONE_GRID * ZONE_GRID; ++c) g.cellStart[c + 1] += g.cellStart[c];
+    }
+    // Each cursor now sits at the end of its cell, i.e. the next cell's start.
+    for (unsigned c = ZONE_GRID * ZONE_GRID; c > 0; --c) g.cellStart[c] = g.cellStart[c - 1];
+    g.cellStart[0] = 0;
+    g.zones = gridZones;
+}
+
+// Distance goes to the zones holding the new point, the time since the
+// previous event to the zones holding the old one.
+inline void ZoneGridTrack(const ZoneGrid& g, Zone* zones, long fromX, long fromY, long toX, long toY,
+    double mm, unsigned elapsedMs) {
+    for (int k = 0; k < 2; ++k) {
+        long x = k == 0 ? toX : fromX, y = k == 0 ? toY : fromY;
+        if (k == 0 && mm <= 0.0) continue;
+        if (k == 1 && elapsedMs == 0) continue;
+        if (x < g.screen.left || y < g.screen.top || x >= g.screen.right || y >= g.screen.bottom) continue;
+        unsigned c = (unsigned)((y - g.screen.top) / g.cellH * ZONE_GRID + (x - g.screen.left) / g.cellW);
+        for (unsigned j = g.cellStart[c]; j < g.cellStart[c + 1]; ++j) {
+            Zone& z = zones[g.cellList[j]];
+            if (x < z.rc.left || x >= z.rc.right || y < z.rc.top || y >= z.rc.bottom) continue;
+            if (k == 0) z.mm += mm;
+            else z.ms += elapsedMs;
+        }
+    }
+}
+
+// History index
+// Daily totals in a table sorted by YYYYMMDD key, with prefix sums beside it
+// (prefix[i] is the sum of days [0, i)), so a date-range total is two binary
+// searches.
+struct HistoryDay {
+    unsigned key;
+    double mm;
+};
+
+inline void HistoryPrefix(const HistoryDay* days, double* prefix, unsigned count, unsigned from) {
+    if (from == 0) prefix[0] = 0.0;
+    for (unsigned i = from; i < count; ++i) prefix[i + 1] = prefix[i] + days[i].mm;
+}
+
+// After a bulk load: sort (keys are usually already in order) and sum.
+inline void HistorySort(HistoryDay* days, double* prefix, unsigned count) {
+    std::sort(days, days + count, [](const HistoryDay& a, const HistoryDay& b) { return a.key < b.key; });
+    HistoryPrefix(days, prefix, count, 0);
+}
+
+// Sealed days normally append; an existing day is updated in place. When the
+// table is full the oldest day makes room, and a day older than all of them
+// is dropped.
+inline void HistoryPut(HistoryDay* days, double* prefix, unsigned& count, unsigned capacity, unsigned key, double mm) {
+    HistoryDay* end = days + count;
+    HistoryDay* it = std::lower_bound(days, end, key, [](const HistoryDay& d, unsigned k) { return d.key < k; });
+    unsigned pos = (unsigned)(it - days);
+    if (it != end && it->key == key) {
+        it->mm = mm;
+    }
+    else if (count == capacity) {
+        if (pos == 0) return;
+        std::move(days + 1, days + pos, days);
+        days[pos - 1] = HistoryDay{ key, mm };
+        pos = 0;
+    }
+    else {
+        std::move_backward(days + pos, end, end + 1);
+        days[pos] = HistoryDay{ key, mm };
+        ++count;
+    }
+    HistoryPrefix(days, prefix, count, pos);
+}
+
+// Sum of the days in [fromKey, toKey].
+inline double HistorySum(const HistoryDay* days, const double* prefix, unsigned count, unsigned fromKey, unsigned toKey) {
+    if (!count || fromKey > toKey || fromKey > days[count - 1].key || toKey < days[0].key) return 0.0;
+    const HistoryDay* end = days + count;
+    const HistoryDay* lo = std::lower_bound(days, end, fromKey, [](const HistoryDay& d, unsigned k) { return d.key < k; });
+    const HistoryDay* hi = std::upper_bound(days, end, toKey, [](unsigned k, const HistoryDay& d) { return k < d.key; });
+    return prefix[hi - days] - prefix[lo - days];
+}
+
+// Tremor
+// The producer spreads each move's distance over the clock time since the
+// previous move and sums it into 10 ms bins, handing finished bins on through
+// a ring. The consumer feeds a 100-sample (1 s) block through one Goertzel
+// filter per 1 Hz bin from 4 to 12 Hz; integer bins over a rectangular block
+// ignore the DC part of the speed, so no mean removal is needed. Each closed
+// block yields its power in three bands: 4-5, 6-7 and 8-12 Hz.
+enum : unsigned {
+    TREMOR_BIN_MS = 10, TREMOR_SPREAD_BINS = 3, TREMOR_BLOCK = 100, TREMOR_RING = 128,
+    TREMOR_K_FIRST = 4, TREMOR_K_LAST = 12, TREMOR_FILTERS = TREMOR_K_LAST - TREMOR_K_FIRST + 1, TREMOR_BANDS = 3
+};
+struct TremorBin {
+    unsigned bin;           // absolute bin number (clock / bin length); wraps
+    float mm;
+};
+struct TremorState {
+    long long lastTick;     // producer: clock of the previous move
+    unsigned bin;           // producer: bin being summed into acc
+    float acc;
+    TremorBin ring[TREMOR_RING];
+    unsigned head, tail;
+    unsigned nextBin;       // consumer: bin expected next
+    unsigned fill, moving;  // samples in the block, and how many were non-zero
+    float coeff[TREMOR_FILTERS];
+    float s1[TREMOR_FILTERS], s2[TREMOR_FILTERS];
+};
+
+inline void TremorAccumulate(TremorState& t, unsigned bin, float mm) {
+    if (bin != t.bin) {
+        unsigned next = (t.head + 1) % TREMOR_RING;
+        if (t.acc > 0.0f && next != t.tail) {
+            t.ring[t.head].bin = t.bin;
+            t.ring[t.head].mm = t.acc;
+            t.head = next;
+        }
+        t.bin = bin;
+        t.acc = 0.0f;
+    }
+    t.acc += mm;
+}
+
+// Producer: resamples onto the bin grid, binTicks clock ticks per bin. A move
+// covers the time since the previous one, so its distance is shared between
+// the bins of that span; a move after a pause longer than TREMOR_SPREAD_BINS
+// lands in its own bin. At most TREMOR_SPREAD_BINS + 1 bins per move,
+// whatever the input rate.
+inline void TremorSpread(TremorState& t, long long tick, long long binTicks, double mm) {
+    long long from = t.lastTick;
+    t.lastTick = tick;
+    if (mm <= 0.0) return;
+    if (tick <= from || tick - from > binTicks * TREMOR_SPREAD_BINS) from = tick - 1;
+    const double perTick = mm / (double)(tick - from);
+    while (from < tick) {
+        long long bin = from / binTicks;
+        long long end = (bin + 1) * binTicks < tick ? (bin + 1) * binTicks : tick;
+        TremorAccumulate(t, (unsigned)bin, (float)(perTick * (double)(end - from)));
+        from = end;
+    }
+}
+
+inline void TremorResetBlock(TremorState& t) {
+    for (unsigned k = 0; k < TREMOR_FILTERS; ++k) t.s1[k] = t.s2[k] = 0.0f;
+    t.fill = 0;
+    t.moving = 0;
+}
+
+// One speed sample (mm/s) into every filter. When the block closes with the
+// hand moving for most of it, onBlock gets the band powers in (mm/s)^2.
+template <class OnBlock>
+inline void TremorFeed(TremorState& t, float speed, OnBlock onBlock) {
+    for (unsigned k = 0; k < TREMOR_FILTERS; ++k) {
+        float s0 = speed + t.coeff[k] * t.s1[k] - t.s2[k];
+        t.s2[k] = t.s1[k];
+        t.s1[k] = s0;
+    }
+    if (speed > 0.0f) ++t.moving;
+    if (++t.fill < TREMOR_BLOCK) return;
+
+    if (t.moving >= TREMOR_BLOCK / 2) {
+        float power[TREMOR_BANDS] = {};
+        for (unsigned k = 0; k < TREMOR_FILTERS; ++k) {
+            float s1 = t.s1[k], s2 = t.s2[k];
+            float mag2 = s1 * s1 + s2 * s2 - t.coeff[k] * s1 * s2;
+            unsigned hz = TREMOR_K_FIRST + k;
+            power[hz < 6 ? 0 : hz < 8 ? 1 : 2] += 2.0f * mag2 / ((float)TREMOR_BLOCK * TREMOR_BLOCK);
+        }
+        onBlock(power);
+    }
+    TremorResetBlock(t);
+}
+
+// Consumer: drains the ring. Bins with no movement are fed as zero speed; a
+// gap longer than a block starts a fresh block.
+template <class OnBlock>
+inline void TremorDrainBins(TremorState& t, OnBlock onBlock) {
+    if (!t.coeff[0]) {
+        for (unsigned k = 0; k < TREMOR_FILTERS; ++k)
+            t.coeff[k] = (float)(2.0 * std::cos(2.0 * 3.14159265358979 * (TREMOR_K_FIRST + k) / TREMOR_BLOCK));
+    }
+    const float perSecond = 1000.0f / TREMOR_BIN_MS;
+    for (; t.tail != t.head; t.tail = (t.tail + 1) % TREMOR_RING) {
+        const TremorBin& b = t.ring[t.tail];
+        unsigned gap = b.bin - t.nextBin;
+        if (t.fill == 0 || gap > TREMOR_BLOCK) {
+            TremorResetBlock(t);
+        }
+        else {
+            for (; gap; --gap) TremorFeed(t, 0.0f, onBlock);
+        }
+        TremorFeed(t, b.mm * perSecond, onBlock);
+        t.nextBin = b.bin + 1;
+    }
+}
+
+// Host fold
+// Each session records how much of its total, and which running flag, its
+// user's saved entry already holds. A fold adds only the difference, so two
+// sessions of the same user add their own movement instead of overwriting
+// each other, and folding a session again adds nothing.
+struct HostUser {
+    wchar_t name[64];
+    double mm;
+    long running;
+};
+
+inline void HostFold(HostUser& u, double total, long running, double& persistedMM, long& persistedRunning) {
+    u.mm += total - persistedMM;
+    if (u.mm < 0.0) u.mm = 0.0;
+    if (running != persistedRunning) u.running = running;
+    persistedMM = total;
+    persistedRunning = running;
+}
@@ -1,8 +1,21 @@
 ﻿// MousePathTracker.cpp
-// Minimal UI: shows only distances (Meters, Kilometers, Miles).
+// Minimal UI: one read-only text view with distances, rates and summaries.
 // No hotkeys, no buttons, no status bar. Fixed-size, no maximize/resize.
-// Minimize-to-tray supported; tray menu offers Restore/Start-Pause/Reset/Exit.
-// Saves state to INI every minute and on exit; loads on start.
+// Minimize-to-tray supported; tray menu offers Restore/Start-Pause/Reset/
+// Export history/Exit.
+// Saves state to INI every minute and on exit; loads on start. All file I/O
+// runs on one background worker thread.
+// Optional screen zones ([Zones] in the INI) collect distance and dwell time.
+// Resting cursor positions are tracked as dwell episodes per app, and the
+// movements between left clicks as Fitts-style aimed movements.
+// Optional host aggregator mode (HostAggregator=1) for terminal servers.
+// The tray menu can open a graph of distance per minute over the last day.
+// Build with MPT_MINIMAL for thin clients: distance, rates, history and export
+// only, in fixed-size tables. Zones, dwell, titles, Fitts, tremor, alerts,
+// per-monitor counts, the graph, the heatmap and the drawn tray icon are
+// compiled out; load and saves run inline on the hook's thread, and the
+// window shows the private working set.
+// "/pgo-train" replays a synthetic trace through the hook for PGO builds.
 //
 // Programmer: Bob Paydar
 //
@@ -13,59 +26,479 @@
 #include <commctrl.h>
 #include <shellapi.h>
 #include <strsafe.h>
-#include <map>
-#include <string>
+#include <psapi.h>
+#include <sddl.h>
+#include <cwchar>
+#include <cstring>
 #include <cmath>
+#include <algorithm>
+#include "MousePathCore.h"
 
 #pragma comment(lib, "comctl32.lib")
 #pragma comment(lib, "Shcore.lib")
+#pragma comment(lib, "Psapi.lib")
 
 #ifndef DPI_AWARENESS_CONTEXT_PER_MONITOR_AWARE_V2
 #define DPI_AWARENESS_CONTEXT_PER_MONITOR_AWARE_V2 ((DPI_AWARENESS_CONTEXT)-4)
 #endif
 
-enum : UINT { WM_TRAYICON = WM_APP + 1, TRAY_ICON_ID = 100, TIMER_UI = 1, TIMER_SAVE = 2 };
+enum : UINT { WM_TRAYICON = WM_APP + 1, WM_STATE_LOADED = WM_APP + 2, WM_DEFERRED_INIT = WM_APP + 3,
+    TRAY_ICON_ID = 100, TIMER_UI = 1, TIMER_SAVE = 2 };
+
+// Everything touched per event or per tick is statically sized; nothing on
+// those paths allocates.
+enum : UINT { MAX_MONITORS = 16, NO_USAGE = 0xFFFFFFFF };
 
 struct MonitorMetrics {
     HMONITOR hmon{};
-    std::wstring device;
+    wchar_t device[CCHDEVICENAME]{};
+    wchar_t id[128]{};           // device interface name; survives re-enumeration and reboots
     double pxPerMM_X{ 0.0 };
     double pxPerMM_Y{ 0.0 };
+    UINT usage{ NO_USAGE };      // slot in g_monitorUsage
+};
+
+#ifndef MPT_MINIMAL
+enum : UINT { MAX_MONITOR_IDS = 32 };
+
+// Per-monitor usage, keyed by the stable id. Layout slots (g_monitors) point
+// into this table, so counts follow a screen when the layout is re-enumerated.
+struct MonitorUsage {
+    wchar_t id[128];
+    double mm;
+    double ms;
+    double crossings;
 };
+MonitorUsage g_monitorUsage[MAX_MONITOR_IDS];
+UINT g_monitorUsageCount{ 0 };
+UINT g_lastMonitorUsage{ NO_USAGE };   // monitor the cursor was last seen on
+ULONGLONG g_monitorTickMs{ 0 };
+#endif
 
 // Globals
 HINSTANCE g_hInst{};
 HWND g_hMain{};
 HWND g_hEdit{};
 HHOOK g_hook{};
+bool g_closePending{ false };    // WM_CLOSE arrived before the worker finished loading
 POINT g_lastPt{};
 bool g_hasLast{ false };
 bool g_running{ true };
 bool g_inTray{ false };
 HICON g_hIcon{};
 double g_totalMM = 0.0;
-std::map<HMONITOR, MonitorMetrics> g_monitors;
+MonitorMetrics g_monitors[MAX_MONITORS];
+UINT g_monitorCount{ 0 };
+MonitorMetrics g_fallbackMetrics;
+bool g_fallbackValid{ false };
+
+// Startup: the hook goes in first; saved state is read by the worker and
+// merged on the UI thread, monitor enumeration runs after the first paint.
+struct LoadedState {
+    double totalMM{ 0.0 };
+    bool running{ true };
+    DWORD dayKey{ 0 };
+    double dayMM{ 0.0 };
+    double injectedMM{ 0.0 };
+};
+LoadedState g_loadedState;
+HANDLE g_loadedEvent{};
+bool g_stateLoaded{ false };
+bool g_hostMode{ false };        // per-user totals go through the host aggregator
+LARGE_INTEGER g_startQpc{};
+LONGLONG g_qpcFreq{ 1 };
+LONGLONG g_replayQpc{ 0 };       // "/pgo-train" clock; 0 = QueryPerformanceCounter
+double g_startupHookMs{ -1.0 };
+double g_startupPaintMs{ -1.0 };
+double g_startupLoadMs{ -1.0 };
+
+// Rollups
+// Distance is folded from g_totalMM into hourly buckets (last 48 hours, in
+// memory) and daily totals (INI [History], YYYYMMDD=mm) on every UI tick.
+// Sealed days older than HistoryDays are pruned or archived a few keys per
+// save, so the INI stays bounded and startup reads only TotalMM and today.
+enum : UINT { ROLLUP_HOURS = 48, HISTORY_PRUNE_PER_SAVE = 16, HISTORY_KEYS_CCH = 8192 };
+double g_hourMM[ROLLUP_HOURS];   // ring indexed by absolute local hour
+ULONGLONG g_rollupHour{ 0 };     // absolute local hour of the newest bucket
+DWORD g_todayKey{ 0 };           // YYYYMMDD being accumulated
+double g_todayMM{ 0.0 };
+double g_rolledMM{ 0.0 };        // part of g_totalMM already folded in
+UINT g_historyDays{ 365 };
+bool g_historyArchive{ false };
+DWORD g_sealedKey{ 0 };          // finished day not yet handed to the worker
+double g_sealedMM{ 0.0 };
+
+// Graph (not in MPT_MINIMAL): distance per local minute for the last day, in
+// a ring next to the hourly one. The graph window decimates it to its pixel
+// width with LTTB into a cached bitmap. Between minutes only the newest
+// segment is redrawn; the whole bitmap is rebuilt once a minute or on resize.
+#ifndef MPT_MINIMAL
+enum : UINT { GRAPH_MINUTES = 24 * 60, GRAPH_MAX_WIDTH = 4096 };
+double g_minuteMM[GRAPH_MINUTES];   // ring indexed by absolute local minute
+ULONGLONG g_rollupMinute{ 0 };      // absolute local minute of the newest bucket
+HWND g_hGraph{};
+HDC g_graphDC{};
+HBITMAP g_graphBmp{}, g_graphOldBmp{};
+int g_graphW{ 0 }, g_graphH{ 0 };
+ULONGLONG g_graphMinute{ 0 };       // minute the bitmap was built for; 0 forces a rebuild
+double g_graphMax{ 0.0 };
+double g_graphTail{ 0.0 };
+double g_graphSeries[GRAPH_MINUTES];
+UINT g_graphPicked[GRAPH_MAX_WIDTH];
+POINT g_graphPts[GRAPH_MAX_WIDTH];
+UINT g_graphCount{ 0 };
+
+// Heatmap viewer (not in MPT_MINIMAL): shows up to HEAT_VIEW_X x HEAT_VIEW_Y
+// cells of one pyramid level, stretched over the window. The mouse wheel
+// picks the level and the arrow keys pan; a repaint reads only the visible
+// rectangle.
+enum : UINT { HEAT_VIEW_X = 16, HEAT_VIEW_Y = 9 };
+HWND g_hHeat{};
+UINT g_heatLevel{ 2 };              // level 2 is the whole grid at 16x9
+UINT g_heatX{ 0 }, g_heatY{ 0 };    // top-left visible cell of the level
+double g_heatShownTotal{ -1.0 };    // top cell when last painted
+#endif
+
+// Sliding windows (MousePathCore.h), moved along by GetTickCount64. Each
+// rollup batch is one add.
+
+// Live rates: distance and move events over the last second, minute and hour.
+enum : UINT { RATE_SECOND, RATE_MINUTE, RATE_HOUR, RATE_WINDOWS };
+SlidingWindow g_rateMM[RATE_WINDOWS] = { { 50, 20 }, { 1000, 60 }, { 60000, 60 } };
+SlidingWindow g_rateEvents[RATE_WINDOWS] = { { 50, 20 }, { 1000, 60 }, { 60000, 60 } };
+ULONGLONG g_moveEvents{ 0 };     // hook: every WM_MOUSEMOVE while running
+ULONGLONG g_rolledEvents{ 0 };
+
+#ifndef MPT_MINIMAL
+// Alerts: rules from [Alerts] (MousePathCore.h) are checked on the UI tick
+// against the hourly distance window.
+AlertRules g_alertRules{ 0, 0, 5, 30 };
+AlertState g_alerts{};
+wchar_t g_lastAlert[128];
+#endif
+
+// Tray icon: while in the tray the icon shows today's distance (meters below
+// 1 km, then km; MPT_MINIMAL keeps the application icon). Digits come from a
+// built-in 3x5 pixel font and are drawn into one reused 32-bit DIB; the shell
+// gets a new icon only when the text changes, and at most once per
+// TRAY_MODIFY_MIN_MS. The tooltip carries totals and the one-minute rate,
+// sent only when it changes and at most once per TRAY_TIP_MIN_MS. Every
+// Shell_NotifyIconW call is counted over a rolling hour.
+enum : UINT { TRAY_ICON_MAX = 64, TRAY_MODIFY_MIN_MS = 2000, TRAY_TIP_MIN_MS = 1000 };
+#ifndef MPT_MINIMAL
+HBITMAP g_trayColor{}, g_trayMask{};
+DWORD* g_trayBits{};
+int g_traySize{ 0 };
+#endif
+HICON g_trayIcon{};
+wchar_t g_trayText[8];
+ULONGLONG g_trayModifiedMs{ 0 };
+wchar_t g_trayTip[128];
+ULONGLONG g_trayTipMs{ 0 };
+SlidingWindow g_shellCalls{ 60000, 60 };
+DWORD g_gdiPeak{ 0 };
+
+// History index: sealed days are loaded once into a sorted table with prefix
+// sums (MousePathCore.h), so a date-range total is two binary searches
+// instead of INI reads.
+#ifdef MPT_MINIMAL
+enum : UINT { HISTORY_INDEX_DAYS = 400 };
+#else
+enum : UINT { HISTORY_INDEX_DAYS = 4096 };
+#endif
+HistoryDay g_historyIndex[HISTORY_INDEX_DAYS];
+double g_historyPrefixMM[HISTORY_INDEX_DAYS + 1];
+UINT g_historyCount{ 0 };
+SRWLOCK g_historyLock = SRWLOCK_INIT; // UI thread writes, worker reads for export
+
+// Hook: time of the previous move, in hook ticks and on the QPC clock.
+DWORD g_lastMoveTime{ 0 };
+LONGLONG g_lastMoveQpc{ 0 };
+
+#ifndef MPT_MINIMAL
+// Zones: user-defined rectangles in virtual-screen pixels (INI [Zones],
+// Name=left,top,right,bottom) that collect distance and dwell time, looked up
+// through a uniform grid over the virtual screen (MousePathCore.h).
+enum : UINT { MAX_ZONES = 1024, ZONE_IDLE_CAP_MS = 60 * 1000 };
+Zone g_zones[MAX_ZONES];
+UINT g_zoneCount{ 0 };
+ZoneGrid g_zoneGrid{};
+
+// Dwell: sampled on each UI tick from the hook's last position, so the hook
+// itself does no extra work. The cursor dwells while it stays within
+// DWELL_RADIUS_PX of where it came to rest; episodes of at least DWELL_MIN_MS
+// feed a coarse heatmap over the virtual screen and a per-app table.
+// The heatmap is kept as a pyramid: level 0 is the DWELL_GRID_X x
+// DWELL_GRID_Y grid, each level above sums 2x2 cells of the one below, up to
+// a single cell. An episode updates one cell per level; a viewer at any zoom
+// reads only the cells of the level and rectangle it shows.
+enum : UINT { DWELL_RADIUS_PX = 6, DWELL_MIN_MS = 500, DWELL_MAX_MS = 5 * 60 * 1000,
+    DWELL_GRID_X = 64, DWELL_GRID_Y = 36, DWELL_LEVELS = 7, MAX_APPS = 32 };
+constexpr UINT HeatW(UINT level) { return PyramidSide(DWELL_GRID_X, level); }
+constexpr UINT HeatH(UINT level) { return PyramidSide(DWELL_GRID_Y, level); }
+constexpr UINT HeatOffset(UINT level) { return PyramidOffset(DWELL_GRID_X, DWELL_GRID_Y, level); }
+static_assert(HeatW(DWELL_LEVELS - 1) == 1 && HeatH(DWELL_LEVELS - 1) == 1, "pyramid must end in one cell");
+struct DwellEpisode {
+    POINT pt;
+    DWORD durationMs;
+    int monitor;            // index into g_monitors, -1 if unknown
+    wchar_t app[64];
+};
+struct AppDwell {
+    wchar_t app[64];
+    double ms;
+};
+POINT g_dwellAnchor{};
+ULONGLONG g_dwellStart{ 0 };
+bool g_dwellActive{ false };
+DwellEpisode g_lastDwell{};
+double g_dwellHeat[HeatOffset(DWELL_LEVELS)];   // ms per cell, all levels, row-major
+AppDwell g_appDwell[MAX_APPS];
+UINT g_appCount{ 0 };
+
+// Window titles: sampled on the UI tick. Distance per title goes into a
+// Space-Saving summary of TITLE_TOPK counters (any title with more than
+// 1/TITLE_TOPK of the distance is guaranteed a counter; err bounds the
+// overcount). Distinct titles per day go into a HyperLogLog of
+// 2^HLL_BITS one-byte registers (about 3% error); two days or two machines
+// merge by taking the larger register. Both live in MousePathCore.h.
+enum : UINT { TITLE_TOPK = 64, HLL_BITS = 10, HLL_REGISTERS = 1 << HLL_BITS };
+TitleCounter g_titles[TITLE_TOPK];
+UINT g_titleCount{ 0 };
+double g_titleRolledMM{ 0.0 };
+ULONGLONG g_titleHash{ 0 };        // hash of the title seen on the last tick
+BYTE g_windowsHll[HLL_REGISTERS];
+DWORD g_windowsDay{ 0 };           // YYYYMMDD the registers belong to
+
+// Fitts: each movement between two left-button presses is measured in the
+// hook (MousePathCore.h), then queued through a small ring to the UI tick,
+// which attributes it to the foreground app and the hour of day. Throughput
+// uses a nominal target width (FittsTargetPx).
+enum : UINT { FITTS_RING = 16 };
+struct FittsApp {
+    wchar_t app[64];
+    FittsStats stats;
+};
+FittsTracker g_fitts{};
+FittsMovement g_fittsRing[FITTS_RING];
+UINT g_fittsHead{ 0 }, g_fittsTail{ 0 };
+double g_fittsTargetPx{ 32.0 };
+FittsApp g_fittsApps[MAX_APPS];
+UINT g_fittsAppCount{ 0 };
+FittsStats g_fittsHours[24];
+
+// Tremor (optional, Tremor=1): the hook resamples moves onto 10 ms bins over
+// QPC time and the UI tick runs them through the Goertzel bank
+// (MousePathCore.h). Block powers are summed into three bands per local
+// minute, kept in a ring alongside the hourly rollups.
+enum : UINT { TREMOR_MINUTES = 24 * 60 };
+struct TremorMinute {
+    float power[TREMOR_BANDS];   // summed block power, (mm/s)^2
+    WORD blocks;
+};
+bool g_tremorEnabled{ false };
+TremorState g_tremor{};
+TremorMinute g_tremorMinutes[TREMOR_MINUTES];   // ring indexed by absolute local minute
+ULONGLONG g_tremorMinute{ 0 };                  // absolute local minute of the newest entry
+#endif
+
+// Synthetic movement: events the system marks as injected, and runs of the
+// exact same step at the same QPC interval (MousePathCore.h), are counted in
+// g_injectedMM instead of the human total.
+double g_injectedMM{ 0.0 };
+SynthRun g_synthRun{};
+
+// Export: rows are formatted by hand into one reusable buffer that is flushed
+// with WriteFile whenever it fills, so any number of rows uses the same memory.
+enum : UINT { EXPORT_BUFFER_BYTES = 64 * 1024 };
+struct ExportWriter {
+    HANDLE file{ INVALID_HANDLE_VALUE };
+    UINT len{ 0 };
+    bool ok{ false };
+    char buf[EXPORT_BUFFER_BYTES];
+};
+
+// Background worker: one low-priority thread runs every blocking job (startup
+// load, INI saves with history pruning, export, shutdown) in submission order,
+// so the hook thread never waits on disk. Each job kind holds at most one
+// queue entry and a newer request refreshes the pending snapshot, so the
+// queue is bounded by the number of kinds. MPT_MINIMAL runs jobs inline on
+// the UI thread, which also runs the hook; a save there writes only the keys
+// that changed (TotalMM, Running, InjectedMM, today's history), plus the
+// finished day and a few pruned keys after midnight.
+enum WorkKind : UINT { WORK_LOAD, WORK_SAVE, WORK_EXPORT, WORK_STOP, WORK_KINDS };
+
+struct SaveSnapshot {
+    double totalMM;
+    double injectedMM;
+    bool running;
+    DWORD todayKey;
+    double todayMM;
+    DWORD sealedKey;    // day finished since the last save, or 0
+    double sealedMM;
+#ifndef MPT_MINIMAL
+    double zoneMM[MAX_ZONES];
+    double zoneMs[MAX_ZONES];
+    MonitorUsage monitorUsage[MAX_MONITOR_IDS];
+    UINT monitorUsageCount;
+    AppDwell appDwell[MAX_APPS];
+    UINT appCount;
+    TitleCounter titles[TITLE_TOPK];
+    UINT titleCount;
+    BYTE windowsHll[HLL_REGISTERS];
+    DWORD windowsDay;
+    FittsApp fittsApps[MAX_APPS];
+    UINT fittsAppCount;
+    FittsStats fittsHours[24];
+#endif
+};
+
+struct ExportSnapshot {
+    ULONGLONG rollupHour;
+    DWORD todayKey;
+    double todayMM;
+    double hourMM[ROLLUP_HOURS];
+#ifndef MPT_MINIMAL
+    bool tremor;
+    ULONGLONG tremorMinute;
+    TremorMinute tremorMinutes[TREMOR_MINUTES];
+#endif
+};
+
+CRITICAL_SECTION g_workLock;
+CONDITION_VARIABLE g_workReady = CONDITION_VARIABLE_INIT;
+UINT g_workOrder[WORK_KINDS];
+UINT g_workCount{ 0 };
+bool g_workPending[WORK_KINDS];
+SaveSnapshot g_saveSnapshot;
+ExportSnapshot g_exportSnapshot;
+HANDLE g_workThread{};
+bool g_workInline{ false };       // no worker thread: jobs run on the caller
+double g_workMaxMs[WORK_KINDS];
+
+#ifndef MPT_MINIMAL
+// Host aggregator (terminal-server mode)
+// Every session's tracker publishes its totals into one shared table backed by
+// a file next to the INI; a single elected instance persists the whole table.
+// Memory is one fixed table per host, so cost per extra session is one slot.
+// Per-user totals live in one [HostUsers] section (user=mm,running), folded
+// from the slots by HostFold (MousePathCore.h).
+enum : UINT { HOST_MAX_SESSIONS = 256, HOST_MAX_USERS = 1024, HOST_STALE_SECONDS = 5 * 60 };
+enum : LONG { HOST_SLOT_FREE = 0, HOST_SLOT_LIVE = 1, HOST_SLOT_CLOSED = 2, HOST_SLOT_CLAIMING = 3 };
+
+struct HostSlot {
+    volatile LONG state;
+    DWORD sessionId;
+    DWORD pid;
+    LONG running;
+    ULONGLONG heartbeat;   // FILETIME of the last publish
+    double totalMM;
+    double persistedMM;    // part of totalMM already in [HostUsers]; owner-written
+    LONG persistedRunning;
+    wchar_t user[64];
+};
+
+struct HostTable {
+    HostSlot slots[HOST_MAX_SESSIONS];
+};
+
+bool g_hostOwner{ false };
+HANDLE g_hostFile{};
+HANDLE g_hostMap{};
+HANDLE g_hostMutex{};
+HostTable* g_hostTable{};
+HostSlot* g_hostSlot{};
+#endif
 
 // Forward decls
 LRESULT CALLBACK WndProc(HWND, UINT, WPARAM, LPARAM);
 LRESULT CALLBACK LowLevelMouseProc(int nCode, WPARAM wParam, LPARAM lParam);
 void EnumerateMonitors();
-MonitorMetrics GetMetricsAtPoint(POINT pt);
+const MonitorMetrics& GetMetricsAtPoint(POINT pt);
 void UpdateUI(HWND);
 void ResetCounters();
 void MinimizeToTray(HWND hWnd);
 void RestoreFromTray(HWND hWnd);
 void EnsureTrayIcon(HWND hWnd, bool add);
+void TrayTick(HWND hWnd);
+BOOL ShellNotify(DWORD message, NOTIFYICONDATA* nid);
 HMENU BuildTrayMenu();
-std::wstring GetIniPath();
+const wchar_t* GetIniPath();
 void SaveState();
 void LoadState();
-
-static std::wstring FormatDouble(double v, int decimals = 3) {
-    wchar_t buf[128];
-    StringCchPrintfW(buf, 128, L"%.*f", decimals, v);
-    return buf;
-}
+void ApplyLoadedState();
+void RollupAdvance();
+bool HistoryPrune(const wchar_t* ini);
+void HistoryIndexLoad(const wchar_t* ini);
+void HistoryIndexPut(DWORD key, double mm);
+double HistoryRangeMM(DWORD fromKey, DWORD toKey);
+void ExportHistory(const ExportSnapshot& snap);
+bool SyntheticStep(DWORD flags, LONG dx, LONG dy, LONGLONG interval);
+#ifndef MPT_MINIMAL
+void ZonesLoad(const wchar_t* ini);
+void ZonesBuildGrid();
+void ZonesTrack(POINT from, POINT to, double mm, DWORD elapsedMs);
+void ZonesPersist(const SaveSnapshot& snap, const wchar_t* ini);
+void MonitorsResolve();
+void MonitorsTrack(const MonitorMetrics& m, double mm);
+void MonitorsTick();
+void MonitorsLoad(const wchar_t* ini);
+void MonitorsPersist(const SaveSnapshot& snap, const wchar_t* ini);
+bool ForegroundApp(wchar_t* name, size_t cch);
+void HeatAdd(UINT x, UINT y, double ms);
+UINT HeatQuery(UINT level, UINT x0, UINT y0, UINT x1, UINT y1, double* out);
+bool HeatBusiest(UINT level, UINT* x, UINT* y);
+void TitlesTick();
+void TitlesLoad(const wchar_t* ini);
+void TitlesPersist(const SaveSnapshot& snap, const wchar_t* ini);
+void DwellTick();
+void DwellLoad(const wchar_t* ini);
+void DwellPersist(const SaveSnapshot& snap, const wchar_t* ini);
+void FittsMove(POINT pt, double px);
+void FittsClick(POINT pt, DWORD time);
+void FittsDrain();
+void FittsLoad(const wchar_t* ini);
+void FittsPersist(const SaveSnapshot& snap, const wchar_t* ini);
+void TremorSample(LONGLONG qpc, double mm);
+void TremorDrain();
+void AlertsLoad(const wchar_t* ini);
+void AlertsTick(HWND hWnd);
+void TrayIconFree();
+void MinuteRollup(const FILETIME& now, double delta);
+void GraphToggle();
+void GraphTick();
+void HeatToggle();
+void HeatTick();
+#else
+// Compiled-out features: the hook, tick and layout calls into them do nothing.
+static void ZonesBuildGrid() {}
+static void ZonesTrack(POINT, POINT, double, DWORD) {}
+static void MonitorsResolve() {}
+static void MonitorsTrack(const MonitorMetrics&, double) {}
+static void MonitorsTick() {}
+static void TitlesTick() {}
+static void DwellTick() {}
+static void FittsMove(POINT, double) {}
+static void FittsClick(POINT, DWORD) {}
+static void FittsDrain() {}
+static void TremorSample(LONGLONG, double) {}
+static void TremorDrain() {}
+static void AlertsTick(HWND) {}
+static void TrayIconFree() {}
+static void MinuteRollup(const FILETIME&, double) {}
+#endif
+void WorkStart();
+void WorkSubmit(UINT kind);
+void WorkStop();
+#ifndef MPT_MINIMAL
+bool HostAttach(const wchar_t* ini);
+void HostPublish();
+void HostPersist(const wchar_t* ini);
+void HostDetach();
+#else
+static void HostPublish() {}
+static void HostDetach() {}
+#endif
 
 static BOOL CALLBACK MonEnumProc(HMONITOR hMon, HDC, LPRECT, LPARAM) {
     MONITORINFOEXW mi{}; mi.cbSize = sizeof(mi);
@@ -82,26 +515,39 @@ static BOOL CALLBACK MonEnumProc(HMONITOR hMon, HDC, LPRECT, LPARAM) {
         if (vertRes > 0 && vertSizeMM > 0) pxPerMM_Y = (double)vertRes / (double)vertSizeMM;
         DeleteDC(hdc);
     }
-    MonitorMetrics mm{};
+    if (g_monitorCount >= MAX_MONITORS) return FALSE;
+    MonitorMetrics& mm = g_monitors[g_monitorCount++];
     mm.hmon = hMon;
-    mm.device = mi.szDevice;
+    StringCchCopyW(mm.device, ARRAYSIZE(mm.device), mi.szDevice);
+    DISPLAY_DEVICEW dd{}; dd.cb = sizeof(dd);
+    if (EnumDisplayDevicesW(mi.szDevice, 0, &dd, EDD_GET_DEVICE_INTERFACE_NAME) && dd.DeviceID[0])
+        StringCchCopyW(mm.id, ARRAYSIZE(mm.id), dd.DeviceID);
+    else
+        StringCchCopyW(mm.id, ARRAYSIZE(mm.id), mi.szDevice);
+    mm.usage = NO_USAGE;
     mm.pxPerMM_X = pxPerMM_X;
     mm.pxPerMM_Y = pxPerMM_Y;
-    g_monitors[hMon] = mm;
     return TRUE;
 }
 
 void EnumerateMonitors() {
-    g_monitors.clear();
+    g_monitorCount = 0;
+    g_fallbackValid = false;
     EnumDisplayMonitors(NULL, NULL, MonEnumProc, 0);
+    if (g_stateLoaded) {
+        ZonesBuildGrid();
+        MonitorsResolve();
+    }
 }
 
-MonitorMetrics GetMetricsAtPoint(POINT pt) {
+const MonitorMetrics& GetMetricsAtPoint(POINT pt) {
     HMONITOR h = MonitorFromPoint(pt, MONITOR_DEFAULTTONEAREST);
-    auto it = g_monitors.find(h);
-    if (it != g_monitors.end()) return it->second;
+    for (UINT i = 0; i < g_monitorCount; ++i)
+        if (g_monitors[i].hmon == h) return g_monitors[i];
+    if (g_fallbackValid) return g_fallbackMetrics;
 
-    MonitorMetrics mm{};
+    MonitorMetrics& mm = g_fallbackMetrics;
+    mm = MonitorMetrics{};
     HDC hdc = GetDC(NULL);
     if (hdc) {
         int horzRes = GetDeviceCaps(hdc, HORZRES);
@@ -114,73 +560,1450 @@ MonitorMetrics GetMetricsAtPoint(POINT pt) {
     }
     if (mm.pxPerMM_X <= 0.0) mm.pxPerMM_X = 96.0 / 25.4;
     if (mm.pxPerMM_Y <= 0.0) mm.pxPerMM_Y = 96.0 / 25.4;
+    g_fallbackValid = true;
     return mm;
 }
 
 // Hook
+// MSLLHOOKSTRUCT::time follows the system tick (usually 15.6 ms steps), too
+// coarse for anything timed below that.
+static LONGLONG HookClock() {
+    if (g_replayQpc) return g_replayQpc;
+    LARGE_INTEGER c; QueryPerformanceCounter(&c);
+    return c.QuadPart;
+}
+
 LRESULT CALLBACK LowLevelMouseProc(int nCode, WPARAM wParam, LPARAM lParam) {
     if (nCode == HC_ACTION) {
         MSLLHOOKSTRUCT* p = reinterpret_cast<MSLLHOOKSTRUCT*>(lParam);
         if (wParam == WM_MOUSEMOVE && g_running) {
+            ++g_moveEvents;
             POINT pt = p->pt;
+            LONGLONG now = HookClock();
+            double movedMM = 0.0;
             if (g_hasLast) {
                 LONG dx = pt.x - g_lastPt.x;
                 LONG dy = pt.y - g_lastPt.y;
+                bool synthetic = false;
                 if (dx != 0 || dy != 0) {
+                    synthetic = SyntheticStep(p->flags, dx, dy, now - g_lastMoveQpc);
                     double pdist = std::sqrt((double)dx * dx + (double)dy * dy);
                     if (pdist >= 1.0) {
-                        MonitorMetrics m = GetMetricsAtPoint(pt);
+                        const MonitorMetrics& m = GetMetricsAtPoint(pt);
                         double mmx = (m.pxPerMM_X > 0.0) ? ((double)dx / m.pxPerMM_X) : 0.0;
                         double mmy = (m.pxPerMM_Y > 0.0) ? ((double)dy / m.pxPerMM_Y) : 0.0;
                         double mm = std::sqrt(mmx * mmx + mmy * mmy);
-                        g_totalMM += mm;
+                        if (synthetic) {
+                            g_injectedMM += mm;
+                        }
+                        else {
+                            g_totalMM += mm;
+                            movedMM = mm;
+                        }
+                        // Injected motion stays out of every per-region count.
+                        if (!synthetic) MonitorsTrack(m, movedMM);
                     }
+                    if (!synthetic) FittsMove(pt, pdist);
                 }
+                if (!synthetic) ZonesTrack(g_lastPt, pt, movedMM, p->time - g_lastMoveTime);
             }
+            TremorSample(now, movedMM);
             g_lastPt = pt;
+            g_lastMoveTime = p->time;
+            g_lastMoveQpc = now;
             g_hasLast = true;
         }
+        else if (wParam == WM_LBUTTONDOWN && g_running) {
+            FittsClick(p->pt, p->time);
+        }
     }
     return CallNextHookEx(g_hook, nCode, wParam, lParam);
 }
 
+// Rollups
+static DWORD DayKey(const SYSTEMTIME& st) {
+    return (DWORD)st.wYear * 10000 + st.wMonth * 100 + st.wDay;
+}
+
+// YYYYMMDD key of the local date 'days' days before today.
+static DWORD DayKeyDaysAgo(UINT days) {
+    SYSTEMTIME st; GetLocalTime(&st);
+    st.wHour = st.wMinute = st.wSecond = st.wMilliseconds = 0;
+    FILETIME ft; SystemTimeToFileTime(&st, &ft);
+    ULARGE_INTEGER t; t.LowPart = ft.dwLowDateTime; t.HighPart = ft.dwHighDateTime;
+    t.QuadPart -= (ULONGLONG)days * 864000000000ULL;
+    ft.dwLowDateTime = t.LowPart; ft.dwHighDateTime = t.HighPart;
+    FileTimeToSystemTime(&ft, &st);
+    return DayKey(st);
+}
+
+static void HistoryWriteDay(DWORD key, double mm) {
+    wchar_t name[16], buf[64];
+    StringCchPrintfW(name, ARRAYSIZE(name), L"%lu", key);
+    StringCchPrintfW(buf, ARRAYSIZE(buf), L"%.3f", mm);
+    WritePrivateProfileStringW(L"History", name, buf, GetIniPath());
+}
+
+void RollupAdvance() {
+    SYSTEMTIME st; GetLocalTime(&st);
+    FILETIME ft; SystemTimeToFileTime(&st, &ft);
+    ULONGLONG hour = (((ULONGLONG)ft.dwHighDateTime << 32) | ft.dwLowDateTime) / 36000000000ULL;
+    if (hour != g_rollupHour) {
+        if (g_rollupHour == 0 || hour < g_rollupHour || hour - g_rollupHour >= ROLLUP_HOURS) {
+            for (UINT i = 0; i < ROLLUP_HOURS; ++i) g_hourMM[i] = 0.0;
+        }
+        else {
+            for (ULONGLONG h = g_rollupHour + 1; h <= hour; ++h) g_hourMM[h % ROLLUP_HOURS] = 0.0;
+        }
+        g_rollupHour = hour;
+    }
+
+    DWORD day = DayKey(st);
+    if (day != g_todayKey) {
+        // Seal the finished day; the next save hands it to the worker.
+        if (g_todayKey && g_stateLoaded && !g_hostMode) {
+            g_sealedKey = g_todayKey;
+            g_sealedMM = g_todayMM;
+            HistoryIndexPut(g_todayKey, g_todayMM);
+        }
+        g_todayKey = day;
+        g_todayMM = 0.0;
+    }
+
+    double delta = g_totalMM - g_rolledMM;
+    MinuteRollup(ft, delta > 0.0 ? delta : 0.0);
+    if (delta > 0.0) {
+        g_hourMM[g_rollupHour % ROLLUP_HOURS] += delta;
+        g_todayMM += delta;
+        ULONGLONG now = GetTickCount64();
+        for (UINT i = 0; i < RATE_WINDOWS; ++i) WindowAdd(g_rateMM[i], now, delta);
+#ifndef MPT_MINIMAL
+        AlertActivity(g_alertRules, g_alerts, now);
+#endif
+    }
+    g_rolledMM = g_totalMM;
+    if (g_moveEvents != g_rolledEvents) {
+        ULONGLONG now = GetTickCount64();
+        for (UINT i = 0; i < RATE_WINDOWS; ++i) WindowAdd(g_rateEvents[i], now, (double)(g_moveEvents - g_rolledEvents));
+        g_rolledEvents = g_moveEvents;
+    }
+}
+
+// Worker: returns true while more expired keys remain.
+bool HistoryPrune(const wchar_t* ini) {
+    DWORD cutoff = DayKeyDaysAgo(g_historyDays);
+
+    wchar_t archive[MAX_PATH];
+    StringCchCopyW(archive, ARRAYSIZE(archive), ini);
+    wchar_t* dot = wcsrchr(archive, L'.');
+    if (dot) StringCchCopyW(dot, ARRAYSIZE(archive) - (dot - archive), L"-archive.ini");
+
+    // Keys are appended in date order, so a truncated listing still holds the oldest.
+    static wchar_t keys[HISTORY_KEYS_CCH];
+    GetPrivateProfileStringW(L"History", NULL, L"", keys, HISTORY_KEYS_CCH, ini);
+    UINT removed = 0;
+    for (const wchar_t* k = keys; *k && removed < HISTORY_PRUNE_PER_SAVE; k += wcslen(k) + 1) {
+        if ((DWORD)_wtoi(k) >= cutoff) continue;
+        if (g_historyArchive) {
+            wchar_t buf[64];
+            GetPrivateProfileStringW(L"History", k, L"0", buf, ARRAYSIZE(buf), ini);
+            WritePrivateProfileStringW(L"History", k, buf, archive);
+        }
+        WritePrivateProfileStringW(L"History", k, NULL, ini);
+        ++removed;
+    }
+    return removed == HISTORY_PRUNE_PER_SAVE;
+}
+
+// History index
+// Whole INI section as key=value\0...\0\0 in a temporary heap block (startup,
+// and the host owner's minute save); release with HeapFree.
+static wchar_t* ReadIniSection(const wchar_t* name, DWORD cch, const wchar_t* ini) {
+    wchar_t* section = (wchar_t*)HeapAlloc(GetProcessHeap(), 0, cch * sizeof(wchar_t));
+    if (!section) return NULL;
+    section[0] = section[1] = L'\0';
+    GetPrivateProfileSectionW(name, section, cch, ini);
+    return section;
+}
+
+// Worker: one section read, then sort.
+void HistoryIndexLoad(const wchar_t* ini) {
+    wchar_t* section = ReadIniSection(L"History", HISTORY_INDEX_DAYS * 32, ini);
+    if (!section) return;
+    g_historyCount = 0;
+    for (const wchar_t* e = section; *e && g_historyCount < HISTORY_INDEX_DAYS; e += wcslen(e) + 1) {
+        const wchar_t* eq = wcschr(e, L'=');
+        if (!eq) continue;
+        g_historyIndex[g_historyCount].key = (DWORD)_wtoi(e);
+        g_historyIndex[g_historyCount].mm = _wtof(eq + 1);
+        ++g_historyCount;
+    }
+    HeapFree(GetProcessHeap(), 0, section);
+    HistorySort(g_historyIndex, g_historyPrefixMM, g_historyCount);
+}
+
+// UI thread: under the lock, since the worker reads the table for export.
+void HistoryIndexPut(DWORD key, double mm) {
+    AcquireSRWLockExclusive(&g_historyLock);
+    HistoryPut(g_historyIndex, g_historyPrefixMM, g_historyCount, HISTORY_INDEX_DAYS, key, mm);
+    ReleaseSRWLockExclusive(&g_historyLock);
+}
+
+// Sum of sealed days in [fromKey, toKey] plus today's running total when in range.
+// UI thread only, and only once loading has finished.
+double HistoryRangeMM(DWORD fromKey, DWORD toKey) {
+    double mm = 0.0;
+    if (g_stateLoaded) {
+        mm = HistorySum(g_historyIndex, g_historyPrefixMM, g_historyCount, fromKey, toKey);
+        // Today is counted live below, not from its last saved value.
+        if (g_todayKey >= fromKey && g_todayKey <= toKey)
+            mm -= HistorySum(g_historyIndex, g_historyPrefixMM, g_historyCount, g_todayKey, g_todayKey);
+    }
+    if (g_todayKey >= fromKey && g_todayKey <= toKey) mm += g_todayMM;
+    return mm;
+}
+
+// Export
+static bool ExportOpen(ExportWriter& w, const wchar_t* path) {
+    w.file = CreateFileW(path, GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    w.len = 0;
+    w.ok = (w.file != INVALID_HANDLE_VALUE);
+    return w.ok;
+}
+
+static void ExportFlush(ExportWriter& w) {
+    if (w.ok && w.len) {
+        DWORD written = 0;
+        w.ok = WriteFile(w.file, w.buf, w.len, &written, NULL) && written == w.len;
+    }
+    w.len = 0;
+}
+
+static void ExportClose(ExportWriter& w) {
+    ExportFlush(w);
+    if (w.file != INVALID_HANDLE_VALUE) CloseHandle(w.file);
+    w.file = INVALID_HANDLE_VALUE;
+}
+
+// Every row is far shorter than this; callers reserve before appending.
+static void ExportReserve(ExportWriter& w) {
+    if (w.len > EXPORT_BUFFER_BYTES - 256) ExportFlush(w);
+}
+
+static void ExportPut(ExportWriter& w, const char* s) {
+    while (*s) w.buf[w.len++] = *s++;
+}
+
+static void ExportUInt(ExportWriter& w, ULONGLONG v, int width = 0) {
+    char tmp[24];
+    int n = 0;
+    do { tmp[n++] = (char)('0' + v % 10); v /= 10; } while (v);
+    while (n < width) tmp[n++] = '0';
+    while (n) w.buf[w.len++] = tmp[--n];
+}
+
+// Millimeters as meters with three decimals, via integer math.
+static void ExportMeters(ExportWriter& w, double mm) {
+    ULONGLONG v = (ULONGLONG)(mm > 0.0 ? mm + 0.5 : 0.0);
+    ExportUInt(w, v / 1000);
+    w.buf[w.len++] = '.';
+    ExportUInt(w, v % 1000, 3);
+}
+
+static void ExportDate(ExportWriter& w, DWORD key) {
+    ExportUInt(w, key / 10000, 4);
+    w.buf[w.len++] = '-';
+    ExportUInt(w, key / 100 % 100, 2);
+    w.buf[w.len++] = '-';
+    ExportUInt(w, key % 100, 2);
+}
+
+static void ExportRow(ExportWriter& csv, ExportWriter& jsonl, const char* kind, DWORD key, int hour, double mm) {
+    ExportReserve(csv);
+    ExportPut(csv, kind); ExportPut(csv, ",");
+    ExportDate(csv, key);
+    if (hour >= 0) { ExportPut(csv, "T"); ExportUInt(csv, hour, 2); ExportPut(csv, ":00"); }
+    ExportPut(csv, ",");
+    ExportMeters(csv, mm);
+    ExportPut(csv, "\n");
+
+    ExportReserve(jsonl);
+    ExportPut(jsonl, "{\"kind\":\""); ExportPut(jsonl, kind); ExportPut(jsonl, "\",\"start\":\"");
+    ExportDate(jsonl, key);
+    if (hour >= 0) { ExportPut(jsonl, "T"); ExportUInt(jsonl, hour, 2); ExportPut(jsonl, ":00"); }
+    ExportPut(jsonl, "\",\"distance_m\":");
+    ExportMeters(jsonl, mm);
+    ExportPut(jsonl, "}\n");
+}
+
+// Worker: writes daily history and the hourly ring next to the INI as
+// <name>-history.csv and <name>-history.jsonl.
+void ExportHistory(const ExportSnapshot& snap) {
+    static ExportWriter csv, jsonl;
+    wchar_t path[MAX_PATH];
+    StringCchCopyW(path, ARRAYSIZE(path), GetIniPath());
+    wchar_t* dot = wcsrchr(path, L'.');
+    if (!dot) return;
+    size_t room = ARRAYSIZE(path) - (dot - path);
+    StringCchCopyW(dot, room, L"-history.csv");
+    if (!ExportOpen(csv, path)) return;
+    StringCchCopyW(dot, room, L"-history.jsonl");
+    if (!ExportOpen(jsonl, path)) { ExportClose(csv); return; }
+
+    ExportPut(csv, "kind,start,distance_m\n");
+    AcquireSRWLockShared(&g_historyLock);
+    for (UINT i = 0; i < g_historyCount; ++i) {
+        if (g_historyIndex[i].key == snap.todayKey) continue;
+        ExportRow(csv, jsonl, "day", g_historyIndex[i].key, -1, g_historyIndex[i].mm);
+    }
+    ReleaseSRWLockShared(&g_historyLock);
+    if (snap.todayKey) ExportRow(csv, jsonl, "day", snap.todayKey, -1, snap.todayMM);
+
+    ULONGLONG first = snap.rollupHour >= ROLLUP_HOURS ? snap.rollupHour - ROLLUP_HOURS + 1 : 0;
+    for (ULONGLONG h = first; h <= snap.rollupHour; ++h) {
+        ULARGE_INTEGER t; t.QuadPart = h * 36000000000ULL;
+        FILETIME ft; ft.dwLowDateTime = t.LowPart; ft.dwHighDateTime = t.HighPart;
+        SYSTEMTIME st; FileTimeToSystemTime(&ft, &st);
+        ExportRow(csv, jsonl, "hour", DayKey(st), st.wHour, snap.hourMM[h % ROLLUP_HOURS]);
+    }
+    ExportClose(csv);
+    ExportClose(jsonl);
+
+#ifndef MPT_MINIMAL
+    // Tremor minutes: RMS speed per band in mm/s (ExportMeters on a scaled value).
+    if (!snap.tremor || !snap.tremorMinute) return;
+    StringCchCopyW(dot, room, L"-tremor.csv");
+    if (!ExportOpen(csv, path)) return;
+    ExportPut(csv, "minute,blocks,rms_4_6hz,rms_6_8hz,rms_8_12hz\n");
+    ULONGLONG firstMinute = snap.tremorMinute >= TREMOR_MINUTES ? snap.tremorMinute - TREMOR_MINUTES + 1 : 0;
+    for (ULONGLONG m = firstMinute; m <= snap.tremorMinute; ++m) {
+        const TremorMinute& t = snap.tremorMinutes[m % TREMOR_MINUTES];
+        if (!t.blocks) continue;
+        ULARGE_INTEGER u; u.QuadPart = m * 600000000ULL;
+        FILETIME ft; ft.dwLowDateTime = u.LowPart; ft.dwHighDateTime = u.HighPart;
+        SYSTEMTIME st; FileTimeToSystemTime(&ft, &st);
+        ExportReserve(csv);
+        ExportDate(csv, DayKey(st));
+        ExportPut(csv, "T"); ExportUInt(csv, st.wHour, 2);
+        ExportPut(csv, ":"); ExportUInt(csv, st.wMinute, 2);
+        ExportPut(csv, ","); ExportUInt(csv, t.blocks);
+        for (UINT b = 0; b < TREMOR_BANDS; ++b) {
+            ExportPut(csv, ",");
+            ExportMeters(csv, 1000.0 * std::sqrt(t.power[b] / t.blocks));
+        }
+        ExportPut(csv, "\n");
+    }
+    ExportClose(csv);
+#endif
+}
+
+#ifndef MPT_MINIMAL
+// Zones
+// Worker (startup): zone rectangles from [Zones], saved totals from [ZoneTotals].
+void ZonesLoad(const wchar_t* ini) {
+    g_zoneCount = 0;
+    wchar_t* section = ReadIniSection(L"Zones", MAX_ZONES * 64, ini);
+    if (!section) return;
+    for (const wchar_t* e = section; *e && g_zoneCount < MAX_ZONES; e += wcslen(e) + 1) {
+        const wchar_t* eq = wcschr(e, L'=');
+        if (!eq || eq == e) continue;
+        Zone& z = g_zones[g_zoneCount];
+        z = Zone{};
+        StringCchCopyNW(z.name, ARRAYSIZE(z.name), e, eq - e);
+        if (swscanf_s(eq + 1, L"%ld,%ld,%ld,%ld", &z.rc.left, &z.rc.top, &z.rc.right, &z.rc.bottom) != 4) continue;
+        if (z.rc.right <= z.rc.left || z.rc.bottom <= z.rc.top) continue;
+        ++g_zoneCount;
+    }
+    HeapFree(GetProcessHeap(), 0, section);
+    if (!g_zoneCount) return;
+
+    section = ReadIniSection(L"ZoneTotals", MAX_ZONES * 64, ini);
+    if (!section) return;
+    for (const wchar_t* e = section; *e; e += wcslen(e) + 1) {
+        const wchar_t* eq = wcschr(e, L'=');
+        if (!eq) continue;
+        for (UINT i = 0; i < g_zoneCount; ++i) {
+            Zone& z = g_zones[i];
+            if (wcsncmp(z.name, e, eq - e) != 0 || z.name[eq - e] != L'\0') continue;
+            swscanf_s(eq + 1, L"%lf,%lf", &z.mm, &z.ms);
+            break;
+        }
+    }
+    HeapFree(GetProcessHeap(), 0, section);
+}
+
+// UI thread: the grid over the current virtual screen.
+void ZonesBuildGrid() {
+    ZoneRect screen;
+    screen.left = GetSystemMetrics(SM_XVIRTUALSCREEN);
+    screen.top = GetSystemMetrics(SM_YVIRTUALSCREEN);
+    screen.right = screen.left + GetSystemMetrics(SM_CXVIRTUALSCREEN);
+    screen.bottom = screen.top + GetSystemMetrics(SM_CYVIRTUALSCREEN);
+    ZoneGridBuild(g_zoneGrid, g_zones, g_zoneCount, screen);
+}
+
+// Hook: the elapsed time is capped for idle periods.
+void ZonesTrack(POINT from, POINT to, double mm, DWORD elapsedMs) {
+    if (!g_zoneCount || !g_stateLoaded) return;
+    if (elapsedMs > ZONE_IDLE_CAP_MS) elapsedMs = ZONE_IDLE_CAP_MS;
+    ZoneGridTrack(g_zoneGrid, g_zones, from.x, from.y, to.x, to.y, mm, elapsedMs);
+}
+
+// Worker: the whole [ZoneTotals] section in one write.
+void ZonesPersist(const SaveSnapshot& snap, const wchar_t* ini) {
+    static wchar_t section[MAX_ZONES * 80 + 1];
+    size_t used = 0;
+    for (UINT i = 0; i < g_zoneCount; ++i) {
+        size_t room = ARRAYSIZE(section) - 1 - used;
+        if (FAILED(StringCchPrintfW(section + used, room, L"%s=%.3f,%.0f", g_zones[i].name, snap.zoneMM[i], snap.zoneMs[i])))
+            break;
+        used += wcslen(section + used) + 1;
+    }
+    section[used] = L'\0';
+    WritePrivateProfileSectionW(L"ZoneTotals", section, ini);
+}
+
+// Monitors
+// UI thread, after load and after every re-enumeration: point each layout
+// slot at its usage entry, adding entries for screens not seen before.
+void MonitorsResolve() {
+    for (UINT i = 0; i < g_monitorCount; ++i) {
+        MonitorMetrics& m = g_monitors[i];
+        m.usage = NO_USAGE;
+        for (UINT u = 0; u < g_monitorUsageCount; ++u) {
+            if (lstrcmpiW(g_monitorUsage[u].id, m.id) == 0) { m.usage = u; break; }
+        }
+        if (m.usage == NO_USAGE && g_monitorUsageCount < MAX_MONITOR_IDS) {
+            MonitorUsage& u = g_monitorUsage[g_monitorUsageCount];
+            u = MonitorUsage{};
+            StringCchCopyW(u.id, ARRAYSIZE(u.id), m.id);
+            m.usage = g_monitorUsageCount++;
+        }
+    }
+}
+
+// Hook: distance on the monitor under the cursor, plus a crossing on entry.
+void MonitorsTrack(const MonitorMetrics& m, double mm) {
+    if (m.usage == NO_USAGE) return;
+    MonitorUsage& u = g_monitorUsage[m.usage];
+    u.mm += mm;
+    if (m.usage != g_lastMonitorUsage) {
+        if (g_lastMonitorUsage != NO_USAGE) u.crossings += 1.0;
+        g_lastMonitorUsage = m.usage;
+    }
+}
+
+// UI thread, every TIMER_UI tick: time goes to the monitor holding the cursor,
+// but, as with zones, no more than ZONE_IDLE_CAP_MS past the last movement.
+void MonitorsTick() {
+    ULONGLONG now = GetTickCount64();
+    if (g_running && g_stateLoaded && g_lastMonitorUsage != NO_USAGE && g_monitorTickMs && g_alerts.lastActiveMs) {
+        ULONGLONG until = (std::min)(now, g_alerts.lastActiveMs + ZONE_IDLE_CAP_MS);
+        if (until > g_monitorTickMs) g_monitorUsage[g_lastMonitorUsage].ms += (double)(until - g_monitorTickMs);
+    }
+    g_monitorTickMs = now;
+}
+
+// Worker (startup): [Monitors] id=mm,ms,crossings.
+void MonitorsLoad(const wchar_t* ini) {
+    g_monitorUsageCount = 0;
+    wchar_t* section = ReadIniSection(L"Monitors", MAX_MONITOR_IDS * 192, ini);
+    if (!section) return;
+    for (const wchar_t* e = section; *e && g_monitorUsageCount < MAX_MONITOR_IDS; e += wcslen(e) + 1) {
+        const wchar_t* eq = wcschr(e, L'=');
+        if (!eq || eq == e) continue;
+        MonitorUsage& u = g_monitorUsage[g_monitorUsageCount];
+        u = MonitorUsage{};
+        StringCchCopyNW(u.id, ARRAYSIZE(u.id), e, eq - e);
+        if (swscanf_s(eq + 1, L"%lf,%lf,%lf", &u.mm, &u.ms, &u.crossings) == 3) ++g_monitorUsageCount;
+    }
+    HeapFree(GetProcessHeap(), 0, section);
+}
+
+// Worker: the whole [Monitors] section in one write.
+void MonitorsPersist(const SaveSnapshot& snap, const wchar_t* ini) {
+    static wchar_t section[MAX_MONITOR_IDS * 192 + 1];
+    size_t used = 0;
+    for (UINT i = 0; i < snap.monitorUsageCount; ++i) {
+        const MonitorUsage& u = snap.monitorUsage[i];
+        size_t room = ARRAYSIZE(section) - 1 - used;
+        if (FAILED(StringCchPrintfW(section + used, room, L"%s=%.3f,%.0f,%.0f", u.id, u.mm, u.ms, u.crossings)))
+            break;
+        used += wcslen(section + used) + 1;
+    }
+    section[used] = L'\0';
+    WritePrivateProfileSectionW(L"Monitors", section, ini);
+}
+
+// Foreground app
+// Executable name of the foreground window's process. The name is cached per
+// process id, so OpenProcess runs only when the foreground process changes.
+bool ForegroundApp(wchar_t* name, size_t cch) {
+    static DWORD cachedPid = 0;
+    static wchar_t cachedName[64] = L"";
+    HWND fg = GetForegroundWindow();
+    DWORD pid = 0;
+    if (fg) GetWindowThreadProcessId(fg, &pid);
+    if (!pid) return false;
+    if (pid != cachedPid) {
+        cachedPid = pid;
+        StringCchCopyW(cachedName, ARRAYSIZE(cachedName), L"unknown");
+        HANDLE h = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+        if (h) {
+            wchar_t path[MAX_PATH];
+            DWORD len = MAX_PATH;
+            if (QueryFullProcessImageNameW(h, 0, path, &len)) {
+                const wchar_t* base = wcsrchr(path, L'\\');
+                StringCchCopyW(cachedName, ARRAYSIZE(cachedName), base ? base + 1 : path);
+            }
+            CloseHandle(h);
+        }
+    }
+    StringCchCopyW(name, cch, cachedName);
+    return true;
+}
+
+// Window titles
+// UI thread, every TIMER_UI tick: distance since the last tick goes to the
+// foreground title (class name for untitled windows).
+void TitlesTick() {
+    double mm = g_totalMM - g_titleRolledMM;
+    g_titleRolledMM = g_totalMM;
+    if (!g_stateLoaded) return;
+    if (g_windowsDay != g_todayKey) {
+        for (UINT i = 0; i < HLL_REGISTERS; ++i) g_windowsHll[i] = 0;
+        g_windowsDay = g_todayKey;
+        g_titleHash = 0;
+    }
+    HWND fg = GetForegroundWindow();
+    if (!fg) return;
+    wchar_t title[96];
+    // INI keys end at '=' and cannot hold line breaks; '=' is kept and the value is split at the last one.
+    if (!GetWindowTextW(fg, title, ARRAYSIZE(title)) && !GetClassNameW(fg, title, ARRAYSIZE(title))) return;
+    for (wchar_t* c = title; *c; ++c)
+        if (*c == L'\r' || *c == L'\n' || *c == L'[' || *c == L']') *c = L' ';
+    ULONGLONG h = TitleHash(title);
+    if (h != g_titleHash) {
+        HllAdd(g_windowsHll, HLL_BITS, h);
+        g_titleHash = h;
+    }
+    if (mm > 0.0) SpaceSavingAdd(g_titles, g_titleCount, TITLE_TOPK, title, mm);
+}
+
+// Worker (startup): [WindowTitles] title=mm,err and [WindowsSeen].
+void TitlesLoad(const wchar_t* ini) {
+    g_titleCount = 0;
+    wchar_t* section = ReadIniSection(L"WindowTitles", TITLE_TOPK * 160, ini);
+    if (section) {
+        for (const wchar_t* e = section; *e && g_titleCount < TITLE_TOPK; e += wcslen(e) + 1) {
+            const wchar_t* eq = wcsrchr(e, L'=');
+            if (!eq || eq == e) continue;
+            TitleCounter& t = g_titles[g_titleCount];
+            t = TitleCounter{};
+            StringCchCopyNW(t.title, ARRAYSIZE(t.title), e, eq - e);
+            if (swscanf_s(eq + 1, L"%lf,%lf", &t.mm, &t.errMM) == 2) ++g_titleCount;
+        }
+        HeapFree(GetProcessHeap(), 0, section);
+    }
+
+    SYSTEMTIME st; GetLocalTime(&st);
+    wchar_t hex[HLL_REGISTERS * 2 + 2];
+    if ((DWORD)GetPrivateProfileIntW(L"WindowsSeen", L"Day", 0, ini) != DayKey(st)) return;
+    GetPrivateProfileStringW(L"WindowsSeen", L"Registers", L"", hex, ARRAYSIZE(hex), ini);
+    if (wcslen(hex) != HLL_REGISTERS * 2) return;
+    BYTE saved[HLL_REGISTERS];
+    for (UINT i = 0; i < HLL_REGISTERS; ++i) {
+        unsigned v = 0;
+        if (swscanf_s(hex + 2 * i, L"%2x", &v) != 1) return;
+        saved[i] = (BYTE)v;
+    }
+    HllMerge(g_windowsHll, saved, HLL_BITS);
+    g_windowsDay = DayKey(st);
+}
+
+// Worker: the top-K section in one write, plus today's registers as hex.
+void TitlesPersist(const SaveSnapshot& snap, const wchar_t* ini) {
+    static wchar_t section[TITLE_TOPK * 160 + 1];
+    size_t used = 0;
+    for (UINT i = 0; i < snap.titleCount; ++i) {
+        size_t room = ARRAYSIZE(section) - 1 - used;
+        if (FAILED(StringCchPrintfW(section + used, room, L"%s=%.3f,%.3f", snap.titles[i].title, snap.titles[i].mm, snap.titles[i].errMM)))
+            break;
+        used += wcslen(section + used) + 1;
+    }
+    section[used] = L'\0';
+    WritePrivateProfileSectionW(L"WindowTitles", section, ini);
+
+    if (!snap.windowsDay) return;
+    static const wchar_t digits[] = L"0123456789abcdef";
+    wchar_t hex[HLL_REGISTERS * 2 + 1];
+    for (UINT i = 0; i < HLL_REGISTERS; ++i) {
+        hex[2 * i] = digits[snap.windowsHll[i] >> 4];
+        hex[2 * i + 1] = digits[snap.windowsHll[i] & 15];
+    }
+    hex[HLL_REGISTERS * 2] = L'\0';
+    wchar_t day[16];
+    StringCchPrintfW(day, ARRAYSIZE(day), L"%lu", snap.windowsDay);
+    WritePrivateProfileStringW(L"WindowsSeen", L"Day", day, ini);
+    WritePrivateProfileStringW(L"WindowsSeen", L"Registers", hex, ini);
+}
+
+// Heatmap pyramid (MousePathCore.h) over g_dwellHeat.
+void HeatAdd(UINT x, UINT y, double ms) {
+    PyramidAdd(g_dwellHeat, DWELL_GRID_X, DWELL_GRID_Y, DWELL_LEVELS, x, y, ms);
+}
+
+UINT HeatQuery(UINT level, UINT x0, UINT y0, UINT x1, UINT y1, double* out) {
+    return PyramidQuery(g_dwellHeat, DWELL_GRID_X, DWELL_GRID_Y, DWELL_LEVELS, level, x0, y0, x1, y1, out);
+}
+
+// The summary reads level 2 (16x9 cells).
+bool HeatBusiest(UINT level, UINT* x, UINT* y) {
+    return PyramidBusiest(g_dwellHeat, DWELL_GRID_X, DWELL_GRID_Y, DWELL_LEVELS, level, x, y);
+}
+
+// Dwell
+static void DwellEnd(ULONGLONG now) {
+    g_dwellActive = false;
+    ULONGLONG duration = now - g_dwellStart;
+    if (duration < DWELL_MIN_MS) return;
+    if (duration > DWELL_MAX_MS) duration = DWELL_MAX_MS; // away from the desk, not dwelling
+
+    DwellEpisode& e = g_lastDwell;
+    e.pt = g_dwellAnchor;
+    e.durationMs = (DWORD)duration;
+    e.monitor = -1;
+    HMONITOR h = MonitorFromPoint(e.pt, MONITOR_DEFAULTTONEAREST);
+    for (UINT i = 0; i < g_monitorCount; ++i)
+        if (g_monitors[i].hmon == h) e.monitor = (int)i;
+    if (!ForegroundApp(e.app, ARRAYSIZE(e.app))) StringCchCopyW(e.app, ARRAYSIZE(e.app), L"unknown");
+
+    LONG vx = GetSystemMetrics(SM_XVIRTUALSCREEN), vy = GetSystemMetrics(SM_YVIRTUALSCREEN);
+    LONG vw = GetSystemMetrics(SM_CXVIRTUALSCREEN), vh = GetSystemMetrics(SM_CYVIRTUALSCREEN);
+    if (vw > 0 && vh > 0) {
+        LONG gx = (e.pt.x - vx) * (LONG)DWELL_GRID_X / vw;
+        LONG gy = (e.pt.y - vy) * (LONG)DWELL_GRID_Y / vh;
+        if (gx >= 0 && gy >= 0 && gx < (LONG)DWELL_GRID_X && gy < (LONG)DWELL_GRID_Y)
+            HeatAdd((UINT)gx, (UINT)gy, e.durationMs);
+    }
+
+    // Per-app table; when full, the app with the least dwell gives up its slot.
+    UINT slot = g_appCount, least = 0;
+    for (UINT i = 0; i < g_appCount; ++i) {
+        if (lstrcmpiW(g_appDwell[i].app, e.app) == 0) { slot = i; break; }
+        if (g_appDwell[i].ms < g_appDwell[least].ms) least = i;
+    }
+    if (slot == g_appCount) {
+        if (g_appCount < MAX_APPS) ++g_appCount;
+        else slot = least;
+        StringCchCopyW(g_appDwell[slot].app, ARRAYSIZE(g_appDwell[slot].app), e.app);
+        g_appDwell[slot].ms = 0.0;
+    }
+    g_appDwell[slot].ms += e.durationMs;
+}
+
+// UI thread, every TIMER_UI tick.
+void DwellTick() {
+    ULONGLONG now = GetTickCount64();
+    if (!g_running || !g_hasLast || !g_stateLoaded) {
+        if (g_dwellActive) DwellEnd(now);
+        return;
+    }
+    if (g_dwellActive) {
+        LONG dx = g_lastPt.x - g_dwellAnchor.x, dy = g_lastPt.y - g_dwellAnchor.y;
+        if (dx * dx + dy * dy <= (LONG)(DWELL_RADIUS_PX * DWELL_RADIUS_PX)) return;
+        DwellEnd(now);
+    }
+    g_dwellAnchor = g_lastPt;
+    g_dwellStart = now;
+    g_dwellActive = true;
+}
+
+// Worker (startup): saved per-app dwell from [AppDwell].
+void DwellLoad(const wchar_t* ini) {
+    wchar_t* section = ReadIniSection(L"AppDwell", MAX_APPS * 96, ini);
+    if (!section) return;
+    g_appCount = 0;
+    for (const wchar_t* e = section; *e && g_appCount < MAX_APPS; e += wcslen(e) + 1) {
+        const wchar_t* eq = wcschr(e, L'=');
+        if (!eq || eq == e) continue;
+        AppDwell& a = g_appDwell[g_appCount++];
+        StringCchCopyNW(a.app, ARRAYSIZE(a.app), e, eq - e);
+        a.ms = _wtof(eq + 1);
+    }
+    HeapFree(GetProcessHeap(), 0, section);
+}
+
+// Worker: the whole [AppDwell] section in one write.
+void DwellPersist(const SaveSnapshot& snap, const wchar_t* ini) {
+    wchar_t section[MAX_APPS * 96 + 1];
+    size_t used = 0;
+    for (UINT i = 0; i < snap.appCount; ++i) {
+        size_t room = ARRAYSIZE(section) - 1 - used;
+        if (FAILED(StringCchPrintfW(section + used, room, L"%s=%.0f", snap.appDwell[i].app, snap.appDwell[i].ms)))
+            break;
+        used += wcslen(section + used) + 1;
+    }
+    section[used] = L'\0';
+    WritePrivateProfileSectionW(L"AppDwell", section, ini);
+}
+#endif
+
+// Synthetic
+// Hook: a flag test and a few compares per move.
+bool SyntheticStep(DWORD flags, LONG dx, LONG dy, LONGLONG interval) {
+    if (flags & (LLMHF_INJECTED | LLMHF_LOWER_IL_INJECTED)) return true;
+    // No jitter at all: same vector, same timing to within a millisecond.
+    // The interval is QPC ticks; hook ticks are too coarse to tell a steady
+    // fast macro from a 1 kHz hand burst.
+    return SynthStep(g_synthRun, dx, dy, interval, g_qpcFreq / 1000);
+}
+
+#ifndef MPT_MINIMAL
+// Fitts
+// Hook: constant work per move.
+void FittsMove(POINT pt, double px) {
+    if (!g_fitts.armed) return;
+    FittsTrackMove(g_fitts, pt.x, pt.y, px);
+}
+
+// Hook: queues the movement that ends at this press, unless the ring is full.
+void FittsClick(POINT pt, DWORD time) {
+    FittsMovement m;
+    if (!FittsTrackClick(g_fitts, pt.x, pt.y, time, &m)) return;
+    UINT next = (g_fittsHead + 1) % FITTS_RING;
+    if (next == g_fittsTail) return;
+    g_fittsRing[g_fittsHead] = m;
+    g_fittsHead = next;
+}
+
+// UI thread, every TIMER_UI tick. Until FittsLoad has run on the worker the
+// ring stays undrained; FittsClick drops movements once it is full.
+void FittsDrain() {
+    if (!g_stateLoaded || g_fittsTail == g_fittsHead) return;
+    wchar_t app[64];
+    if (!ForegroundApp(app, ARRAYSIZE(app))) StringCchCopyW(app, ARRAYSIZE(app), L"unknown");
+    SYSTEMTIME st; GetLocalTime(&st);
+
+    UINT slot = g_fittsAppCount, least = 0;
+    for (UINT i = 0; i < g_fittsAppCount; ++i) {
+        if (lstrcmpiW(g_fittsApps[i].app, app) == 0) { slot = i; break; }
+        if (g_fittsApps[i].stats.count < g_fittsApps[least].stats.count) least = i;
+    }
+    if (slot == g_fittsAppCount) {
+        if (g_fittsAppCount < MAX_APPS) ++g_fittsAppCount;
+        else slot = least;
+        StringCchCopyW(g_fittsApps[slot].app, ARRAYSIZE(g_fittsApps[slot].app), app);
+        g_fittsApps[slot].stats = FittsStats{};
+    }
+    for (; g_fittsTail != g_fittsHead; g_fittsTail = (g_fittsTail + 1) % FITTS_RING) {
+        FittsAdd(g_fittsApps[slot].stats, g_fittsRing[g_fittsTail], g_fittsTargetPx);
+        FittsAdd(g_fittsHours[st.wHour], g_fittsRing[g_fittsTail], g_fittsTargetPx);
+    }
+}
+
+static bool FittsParse(const wchar_t* v, FittsStats& s) {
+    return swscanf_s(v, L"%lf,%lf,%lf,%lf,%lf", &s.count, &s.sumTP, &s.sumEfficiency, &s.sumOvershootPx, &s.sumMs) == 5;
+}
+
+// Worker (startup): target width and saved sums.
+void FittsLoad(const wchar_t* ini) {
+    g_fittsTargetPx = (double)GetPrivateProfileIntW(L"MousePathTracker", L"FittsTargetPx", 32, ini);
+    if (g_fittsTargetPx < 1.0) g_fittsTargetPx = 1.0;
+    wchar_t* section = ReadIniSection(L"FittsApps", MAX_APPS * 160, ini);
+    if (section) {
+        g_fittsAppCount = 0;
+        for (const wchar_t* e = section; *e && g_fittsAppCount < MAX_APPS; e += wcslen(e) + 1) {
+            const wchar_t* eq = wcschr(e, L'=');
+            if (!eq || eq == e) continue;
+            FittsApp& a = g_fittsApps[g_fittsAppCount];
+            StringCchCopyNW(a.app, ARRAYSIZE(a.app), e, eq - e);
+            if (FittsParse(eq + 1, a.stats)) ++g_fittsAppCount;
+        }
+        HeapFree(GetProcessHeap(), 0, section);
+    }
+    wchar_t key[8], buf[160];
+    for (UINT h = 0; h < 24; ++h) {
+        StringCchPrintfW(key, ARRAYSIZE(key), L"H%02u", h);
+        GetPrivateProfileStringW(L"FittsHours", key, L"", buf, ARRAYSIZE(buf), ini);
+        if (!FittsParse(buf, g_fittsHours[h])) g_fittsHours[h] = FittsStats{};
+    }
+}
+
+static HRESULT FittsFormat(wchar_t* out, size_t cch, const wchar_t* key, const FittsStats& s) {
+    return StringCchPrintfW(out, cch, L"%s=%.0f,%.3f,%.4f,%.1f,%.0f",
+        key, s.count, s.sumTP, s.sumEfficiency, s.sumOvershootPx, s.sumMs);
+}
+
+// Worker: [FittsApps] and [FittsHours], one section write each.
+void FittsPersist(const SaveSnapshot& snap, const wchar_t* ini) {
+    wchar_t section[MAX_APPS * 160 + 1];
+    size_t used = 0;
+    for (UINT i = 0; i < snap.fittsAppCount; ++i) {
+        if (FAILED(FittsFormat(section + used, ARRAYSIZE(section) - 1 - used, snap.fittsApps[i].app, snap.fittsApps[i].stats)))
+            break;
+        used += wcslen(section + used) + 1;
+    }
+    section[used] = L'\0';
+    WritePrivateProfileSectionW(L"FittsApps", section, ini);
+
+    used = 0;
+    for (UINT h = 0; h < 24; ++h) {
+        if (snap.fittsHours[h].count == 0.0) continue;
+        wchar_t key[8];
+        StringCchPrintfW(key, ARRAYSIZE(key), L"H%02u", h);
+        if (FAILED(FittsFormat(section + used, ARRAYSIZE(section) - 1 - used, key, snap.fittsHours[h])))
+            break;
+        used += wcslen(section + used) + 1;
+    }
+    section[used] = L'\0';
+    WritePrivateProfileSectionW(L"FittsHours", section, ini);
+}
+
+// Tremor
+// Hook: onto the 10 ms grid.
+void TremorSample(LONGLONG qpc, double mm) {
+    if (!g_tremorEnabled || !g_stateLoaded) return;
+    TremorSpread(g_tremor, qpc, (std::max)(g_qpcFreq * TREMOR_BIN_MS / 1000, 1LL), mm);
+}
+
+static TremorMinute& TremorMinuteNow() {
+    SYSTEMTIME st; GetLocalTime(&st);
+    FILETIME ft; SystemTimeToFileTime(&st, &ft);
+    ULONGLONG minute = (((ULONGLONG)ft.dwHighDateTime << 32) | ft.dwLowDateTime) / 600000000ULL;
+    if (minute != g_tremorMinute) {
+        if (g_tremorMinute == 0 || minute < g_tremorMinute || minute - g_tremorMinute >= TREMOR_MINUTES) {
+            for (UINT i = 0; i < TREMOR_MINUTES; ++i) g_tremorMinutes[i] = TremorMinute{};
+        }
+        else {
+            for (ULONGLONG m = g_tremorMinute + 1; m <= minute; ++m) g_tremorMinutes[m % TREMOR_MINUTES] = TremorMinute{};
+        }
+        g_tremorMinute = minute;
+    }
+    return g_tremorMinutes[minute % TREMOR_MINUTES];
+}
+
+// UI thread, every TIMER_UI tick: closed blocks go to the current minute.
+void TremorDrain() {
+    if (!g_tremorEnabled || !g_stateLoaded) return;
+    TremorDrainBins(g_tremor, [](const float* power) {
+        TremorMinute& m = TremorMinuteNow();
+        for (UINT b = 0; b < TREMOR_BANDS; ++b) m.power[b] += power[b];
+        if (m.blocks < 0xFFFF) ++m.blocks;
+    });
+}
+
+// Graph
+// UI thread, from RollupAdvance.
+void MinuteRollup(const FILETIME& now, double delta) {
+    ULONGLONG minute = (((ULONGLONG)now.dwHighDateTime << 32) | now.dwLowDateTime) / 600000000ULL;
+    if (minute != g_rollupMinute) {
+        if (g_rollupMinute == 0 || minute < g_rollupMinute || minute - g_rollupMinute >= GRAPH_MINUTES) {
+            for (UINT i = 0; i < GRAPH_MINUTES; ++i) g_minuteMM[i] = 0.0;
+        }
+        else {
+            for (ULONGLONG m = g_rollupMinute + 1; m <= minute; ++m) g_minuteMM[m % GRAPH_MINUTES] = 0.0;
+        }
+        g_rollupMinute = minute;
+    }
+    g_minuteMM[minute % GRAPH_MINUTES] += delta;
+}
+
+static int GraphY(double mm) {
+    return g_graphH - 1 - (int)(mm / g_graphMax * (g_graphH - 1));
+}
+
+// Rebuilds the bitmap: series oldest to newest, decimated to the width.
+static void GraphRender() {
+    RECT rc; GetClientRect(g_hGraph, &rc);
+    int w = (std::min)((int)(rc.right - rc.left), (int)GRAPH_MAX_WIDTH), h = rc.bottom - rc.top;
+    if (w < 3 || h < 3) return;
+    if (w != g_graphW || h != g_graphH || !g_graphDC) {
+        if (g_graphDC) {
+            SelectObject(g_graphDC, g_graphOldBmp);
+            DeleteObject(g_graphBmp);
+            DeleteDC(g_graphDC);
+        }
+        HDC screen = GetDC(g_hGraph);
+        g_graphDC = CreateCompatibleDC(screen);
+        g_graphBmp = CreateCompatibleBitmap(screen, w, h);
+        ReleaseDC(g_hGraph, screen);
+        g_graphOldBmp = (HBITMAP)SelectObject(g_graphDC, g_graphBmp);
+        SelectObject(g_graphDC, GetStockObject(DC_PEN));
+        SetDCPenColor(g_graphDC, RGB(0, 90, 200));
+        g_graphW = w;
+        g_graphH = h;
+    }
+
+    g_graphMax = 1000.0; // at least 1 m per minute of headroom
+    for (UINT i = 0; i < GRAPH_MINUTES; ++i) {
+        double v = g_minuteMM[(g_rollupMinute + 1 + i) % GRAPH_MINUTES];
+        g_graphSeries[i] = v;
+        if (v * 1.25 > g_graphMax) g_graphMax = v * 1.25;
+    }
+    g_graphCount = Lttb(g_graphSeries, GRAPH_MINUTES, (UINT)w, g_graphPicked);
+    for (UINT i = 0; i < g_graphCount; ++i) {
+        g_graphPts[i].x = (LONG)((ULONGLONG)g_graphPicked[i] * (w - 1) / (GRAPH_MINUTES - 1));
+        g_graphPts[i].y = GraphY(g_graphSeries[g_graphPicked[i]]);
+    }
+    RECT all{ 0, 0, w, h };
+    FillRect(g_graphDC, &all, (HBRUSH)GetStockObject(WHITE_BRUSH));
+    Polyline(g_graphDC, g_graphPts, (int)g_graphCount);
+    g_graphMinute = g_rollupMinute;
+    g_graphTail = g_graphSeries[GRAPH_MINUTES - 1];
+    InvalidateRect(g_hGraph, NULL, FALSE);
+}
+
+// UI thread, every TIMER_UI tick while the graph is visible.
+void GraphTick() {
+    if (!g_hGraph || !IsWindowVisible(g_hGraph)) return;
+    double tail = g_minuteMM[g_rollupMinute % GRAPH_MINUTES];
+    if (g_graphMinute != g_rollupMinute || tail > g_graphMax || g_graphCount < 3) {
+        GraphRender();
+        return;
+    }
+    if (tail == g_graphTail) return;
+    // The newest point only moves vertically: repaint the strip right of the
+    // second-to-last point and redraw the two segments that touch it.
+    g_graphTail = tail;
+    POINT& last = g_graphPts[g_graphCount - 1];
+    last.y = GraphY(tail);
+    RECT strip{ g_graphPts[g_graphCount - 2].x + 1, 0, g_graphW, g_graphH };
+    FillRect(g_graphDC, &strip, (HBRUSH)GetStockObject(WHITE_BRUSH));
+    Polyline(g_graphDC, &g_graphPts[g_graphCount - 3], 3);
+    InvalidateRect(g_hGraph, &strip, FALSE);
+}
+
+static LRESULT CALLBACK GraphWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
+    switch (msg) {
+    case WM_PAINT: {
+        PAINTSTRUCT ps;
+        HDC hdc = BeginPaint(hWnd, &ps);
+        if (g_graphDC) BitBlt(hdc, 0, 0, g_graphW, g_graphH, g_graphDC, 0, 0, SRCCOPY);
+        EndPaint(hWnd, &ps);
+        return 0;
+    }
+    case WM_ERASEBKGND:
+        return 1; // the bitmap covers the client area
+    case WM_SIZE:
+        g_graphMinute = 0;
+        GraphTick();
+        return 0;
+    case WM_CLOSE:
+        ShowWindow(hWnd, SW_HIDE);
+        return 0;
+    }
+    return DefWindowProcW(hWnd, msg, wParam, lParam);
+}
+
+// Tray menu: the window and its class are created on first use.
+void GraphToggle() {
+    if (g_hGraph) {
+        ShowWindow(g_hGraph, IsWindowVisible(g_hGraph) ? SW_HIDE : SW_SHOWNORMAL);
+        if (IsWindowVisible(g_hGraph)) { g_graphMinute = 0; GraphTick(); }
+        return;
+    }
+    WNDCLASSEXW wcex{};
+    wcex.cbSize = sizeof(WNDCLASSEXW);
+    wcex.lpfnWndProc = GraphWndProc;
+    wcex.hInstance = g_hInst;
+    wcex.hCursor = LoadCursor(NULL, IDC_ARROW);
+    wcex.lpszClassName = L"MousePathTrackerGraphClass";
+    if (!RegisterClassExW(&wcex)) return;
+    g_hGraph = CreateWindowExW(WS_EX_TOOLWINDOW, wcex.lpszClassName, L"Distance per minute (last 24 h)",
+        WS_OVERLAPPEDWINDOW, CW_USEDEFAULT, 0, 600, 220, NULL, NULL, g_hInst, NULL);
+    if (!g_hGraph) return;
+    ShowWindow(g_hGraph, SW_SHOWNORMAL);
+    GraphTick();
+}
+
+// Heatmap viewer
+// Keeps the view inside the level and names it in the title bar.
+static void HeatClamp() {
+    UINT w = HeatW(g_heatLevel), h = HeatH(g_heatLevel);
+    g_heatX = w > HEAT_VIEW_X ? (std::min)(g_heatX, w - HEAT_VIEW_X) : 0;
+    g_heatY = h > HEAT_VIEW_Y ? (std::min)(g_heatY, h - HEAT_VIEW_Y) : 0;
+    wchar_t title[96];
+    StringCchPrintfW(title, ARRAYSIZE(title), L"Dwell heatmap - level %u of %u (%ux%u), from %u,%u",
+        g_heatLevel, DWELL_LEVELS - 1, w, h, g_heatX, g_heatY);
+    SetWindowTextW(g_hHeat, title);
+    InvalidateRect(g_hHeat, NULL, FALSE);
+}
+
+// Zooming keeps the cell at the centre of the view in place.
+static void HeatZoom(bool in) {
+    if (in ? g_heatLevel == 0 : g_heatLevel + 1 >= DWELL_LEVELS) return;
+    int cx = (int)(g_heatX + HEAT_VIEW_X / 2), cy = (int)(g_heatY + HEAT_VIEW_Y / 2);
+    cx = in ? cx * 2 : cx / 2;
+    cy = in ? cy * 2 : cy / 2;
+    g_heatLevel = in ? g_heatLevel - 1 : g_heatLevel + 1;
+    g_heatX = (UINT)(std::max)(cx - (int)HEAT_VIEW_X / 2, 0);
+    g_heatY = (UINT)(std::max)(cy - (int)HEAT_VIEW_Y / 2, 0);
+    HeatClamp();
+}
+
+// Shades each visible cell from white to red against the busiest one in view.
+static void HeatPaint(HDC hdc, const RECT& rc) {
+    double cells[HEAT_VIEW_X * HEAT_VIEW_Y];
+    UINT x1 = g_heatX + HEAT_VIEW_X, y1 = g_heatY + HEAT_VIEW_Y;
+    UINT n = HeatQuery(g_heatLevel, g_heatX, g_heatY, x1, y1, cells);
+    UINT cols = (std::min)(x1, HeatW(g_heatLevel)) - g_heatX, rows = (std::min)(y1, HeatH(g_heatLevel)) - g_heatY;
+    if (!n || n != cols * rows) return;
+    double peak = 0.0;
+    for (UINT i = 0; i < n; ++i) peak = (std::max)(peak, cells[i]);
+    for (UINT r = 0; r < rows; ++r) {
+        for (UINT c = 0; c < cols; ++c) {
+            int shade = peak > 0.0 ? (int)(255.0 * cells[r * cols + c] / peak) : 0;
+            RECT cell{ (LONG)(rc.right * c / cols), (LONG)(rc.bottom * r / rows),
+                (LONG)(rc.right * (c + 1) / cols), (LONG)(rc.bottom * (r + 1) / rows) };
+            SetDCBrushColor(hdc, RGB(255, 255 - shade, 255 - shade));
+            FillRect(hdc, &cell, (HBRUSH)GetStockObject(DC_BRUSH));
+        }
+    }
+    g_heatShownTotal = g_dwellHeat[HeatOffset(DWELL_LEVELS - 1)];
+}
+
+// UI thread, every TIMER_UI tick: repaint only after a dwell episode or a reset.
+void HeatTick() {
+    if (g_hHeat && IsWindowVisible(g_hHeat) && g_dwellHeat[HeatOffset(DWELL_LEVELS - 1)] != g_heatShownTotal)
+        InvalidateRect(g_hHeat, NULL, FALSE);
+}
+
+static LRESULT CALLBACK HeatWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
+    switch (msg) {
+    case WM_PAINT: {
+        PAINTSTRUCT ps;
+        HDC hdc = BeginPaint(hWnd, &ps);
+        RECT rc; GetClientRect(hWnd, &rc);
+        HeatPaint(hdc, rc);
+        EndPaint(hWnd, &ps);
+        return 0;
+    }
+    case WM_ERASEBKGND:
+        return 1; // the cells cover the client area
+    case WM_SIZE:
+        InvalidateRect(hWnd, NULL, FALSE);
+        return 0;
+    case WM_MOUSEWHEEL:
+        HeatZoom(GET_WHEEL_DELTA_WPARAM(wParam) > 0);
+        return 0;
+    case WM_KEYDOWN:
+        switch (wParam) {
+        case VK_LEFT: if (g_heatX) --g_heatX; break;
+        case VK_RIGHT: ++g_heatX; break;
+        case VK_UP: if (g_heatY) --g_heatY; break;
+        case VK_DOWN: ++g_heatY; break;
+        default: return DefWindowProcW(hWnd, msg, wParam, lParam);
+        }
+        HeatClamp();
+        return 0;
+    case WM_CLOSE:
+        ShowWindow(hWnd, SW_HIDE);
+        return 0;
+    }
+    return DefWindowProcW(hWnd, msg, wParam, lParam);
+}
+
+// Tray menu: the window and its class are created on first use.
+void HeatToggle() {
+    if (g_hHeat) {
+        ShowWindow(g_hHeat, IsWindowVisible(g_hHeat) ? SW_HIDE : SW_SHOWNORMAL);
+        return;
+    }
+    WNDCLASSEXW wcex{};
+    wcex.cbSize = sizeof(WNDCLASSEXW);
+    wcex.lpfnWndProc = HeatWndProc;
+    wcex.hInstance = g_hInst;
+    wcex.hCursor = LoadCursor(NULL, IDC_ARROW);
+    wcex.lpszClassName = L"MousePathTrackerHeatClass";
+    if (!RegisterClassExW(&wcex)) return;
+    g_hHeat = CreateWindowExW(WS_EX_TOOLWINDOW, wcex.lpszClassName, L"Dwell heatmap",
+        WS_OVERLAPPEDWINDOW, CW_USEDEFAULT, 0, 640, 380, NULL, NULL, g_hInst, NULL);
+    if (!g_hHeat) return;
+    HeatClamp();
+    ShowWindow(g_hHeat, SW_SHOWNORMAL);
+}
+
+// Alerts
+// Worker (startup).
+void AlertsLoad(const wchar_t* ini) {
+    g_alertRules.hourlyMeters = GetPrivateProfileIntW(L"Alerts", L"HourlyMeters", 0, ini);
+    g_alertRules.noBreakMinutes = GetPrivateProfileIntW(L"Alerts", L"NoBreakMinutes", 0, ini);
+    g_alertRules.breakMinutes = GetPrivateProfileIntW(L"Alerts", L"BreakMinutes", 5, ini);
+    g_alertRules.repeatMinutes = GetPrivateProfileIntW(L"Alerts", L"RepeatMinutes", 30, ini);
+    if (g_alertRules.breakMinutes == 0) g_alertRules.breakMinutes = 1;
+    if (g_alertRules.repeatMinutes == 0) g_alertRules.repeatMinutes = 1;
+}
+
+static void AlertNotify(HWND hWnd, const wchar_t* message) {
+    StringCchCopyW(g_lastAlert, ARRAYSIZE(g_lastAlert), message);
+    if (!g_inTray) return; // the window shows g_lastAlert; there is no icon to attach a balloon to
+    NOTIFYICONDATA nid{};
+    nid.cbSize = sizeof(nid);
+    nid.hWnd = hWnd;
+    nid.uID = TRAY_ICON_ID;
+    nid.uFlags = NIF_INFO;
+    nid.dwInfoFlags = NIIF_INFO;
+    StringCchCopyW(nid.szInfoTitle, ARRAYSIZE(nid.szInfoTitle), L"Mouse Path Tracker");
+    StringCchCopyW(nid.szInfo, ARRAYSIZE(nid.szInfo), message);
+    ShellNotify(NIM_MODIFY, &nid);
+}
+
+// UI thread, every TIMER_UI tick after RollupAdvance.
+void AlertsTick(HWND hWnd) {
+    double meters = 0.0;
+    ULONGLONG activeMin = 0;
+    UINT fired = AlertCheck(g_alertRules, g_alerts, g_rateMM[RATE_HOUR], GetTickCount64(), &meters, &activeMin);
+    wchar_t message[128];
+    if (fired & ALERT_HOURLY) {
+        StringCchPrintfW(message, ARRAYSIZE(message), L"%.0f m of mouse travel in the last hour.", meters);
+        AlertNotify(hWnd, message);
+    }
+    if (fired & ALERT_NO_BREAK) {
+        StringCchPrintfW(message, ARRAYSIZE(message), L"No break for %llu minutes. Time to rest your hand.", activeMin);
+        AlertNotify(hWnd, message);
+    }
+}
+#endif
+
 // UI
+#ifdef MPT_MINIMAL
+// Resident pages not shared with any other process. The page list is copied
+// into a temporary block at most every few seconds and released right away.
+static SIZE_T PrivateWorkingSetKB() {
+    static ULONGLONG lastMs = 0;
+    static SIZE_T cachedKB = 0;
+    ULONGLONG now = GetTickCount64();
+    if (lastMs && now - lastMs < 5000) return cachedKB;
+    lastMs = now;
+    HANDLE process = GetCurrentProcess();
+    PSAPI_WORKING_SET_INFORMATION probe{};
+    if (QueryWorkingSet(process, &probe, sizeof(probe)) || GetLastError() != ERROR_BAD_LENGTH) return cachedKB;
+    // The set can grow between the two calls.
+    SIZE_T bytes = sizeof(PSAPI_WORKING_SET_INFORMATION) + (probe.NumberOfEntries + 64) * sizeof(PSAPI_WORKING_SET_BLOCK);
+    PSAPI_WORKING_SET_INFORMATION* info = (PSAPI_WORKING_SET_INFORMATION*)HeapAlloc(GetProcessHeap(), 0, bytes);
+    if (!info) return cachedKB;
+    if (QueryWorkingSet(process, info, (DWORD)bytes)) {
+        SYSTEM_INFO si; GetSystemInfo(&si);
+        SIZE_T pages = 0;
+        for (ULONG_PTR i = 0; i < info->NumberOfEntries; ++i)
+            if (!info->WorkingSetInfo[i].Shared) ++pages;
+        cachedKB = pages * si.dwPageSize / 1024;
+    }
+    HeapFree(GetProcessHeap(), 0, info);
+    return cachedKB;
+}
+#endif
+
 void UpdateUI(HWND hWnd) {
     double total_m = g_totalMM / 1000.0;
     double total_km = total_m / 1000.0;
     double total_mi = total_m / 1609.344;
 
-    std::wstring text =
+    wchar_t text[2048];
+    StringCchPrintfW(text, ARRAYSIZE(text),
         L"Mouse Path Distance (global):\r\n"
-        L"  • Meters:     " + FormatDouble(total_m, 4) + L" m\r\n" +
-        L"  • Kilometers: " + FormatDouble(total_km, 6) + L" km\r\n" +
-        L"  • Miles:      " + FormatDouble(total_mi, 6) + L" mi\r\n";
+        L"  • Meters:     %.4f m\r\n"
+        L"  • Kilometers: %.6f km\r\n"
+        L"  • Miles:      %.6f mi\r\n",
+        total_m, total_km, total_mi);
+    size_t len = 0;
+    StringCchLengthW(text, ARRAYSIZE(text), &len);
+    StringCchPrintfW(text + len, ARRAYSIZE(text) - len,
+        L"\r\nToday:        %.1f m\r\n"
+        L"Last 7 days:  %.1f m\r\n"
+        L"Last 30 days: %.1f m\r\n",
+        g_todayMM / 1000.0,
+        HistoryRangeMM(DayKeyDaysAgo(6), g_todayKey) / 1000.0,
+        HistoryRangeMM(DayKeyDaysAgo(29), g_todayKey) / 1000.0);
+    // m/min and events/s, scaled from each window's own length.
+    ULONGLONG now = GetTickCount64();
+    double rateM[RATE_WINDOWS], rateEv[RATE_WINDOWS];
+    for (UINT i = 0; i < RATE_WINDOWS; ++i) {
+        double seconds = (double)(g_rateMM[i].bucketMs * g_rateMM[i].buckets) / 1000.0;
+        rateM[i] = WindowSum(g_rateMM[i], now) / 1000.0 * 60.0 / seconds;
+        rateEv[i] = WindowSum(g_rateEvents[i], now) / seconds;
+    }
+    StringCchLengthW(text, ARRAYSIZE(text), &len);
+    StringCchPrintfW(text + len, ARRAYSIZE(text) - len,
+        L"Rate 1 s / 1 min / 1 h: %.1f / %.1f / %.1f m/min, %.0f / %.0f / %.0f moves/s\r\n",
+        rateM[RATE_SECOND], rateM[RATE_MINUTE], rateM[RATE_HOUR],
+        rateEv[RATE_SECOND], rateEv[RATE_MINUTE], rateEv[RATE_HOUR]);
+    if (g_stateLoaded && g_injectedMM > 0.0) {
+        StringCchLengthW(text, ARRAYSIZE(text), &len);
+        StringCchPrintfW(text + len, ARRAYSIZE(text) - len, L"Scripted/injected (not counted): %.1f m\r\n",
+            g_injectedMM / 1000.0);
+    }
+#ifndef MPT_MINIMAL
+    if (g_stateLoaded) {
+        for (UINT i = 0; i < g_zoneCount && i < 4; ++i) {
+            StringCchLengthW(text, ARRAYSIZE(text), &len);
+            StringCchPrintfW(text + len, ARRAYSIZE(text) - len, L"Zone %s: %.1f m, %.1f min\r\n",
+                g_zones[i].name, g_zones[i].mm / 1000.0, g_zones[i].ms / 60000.0);
+        }
+        for (UINT i = 0; i < g_monitorCount; ++i) {
+            if (g_monitors[i].usage == NO_USAGE) continue;
+            const MonitorUsage& u = g_monitorUsage[g_monitors[i].usage];
+            const wchar_t* name = g_monitors[i].device;
+            if (wcsncmp(name, L"\\\\.\\", 4) == 0) name += 4;
+            StringCchLengthW(text, ARRAYSIZE(text), &len);
+            StringCchPrintfW(text + len, ARRAYSIZE(text) - len, L"%s: %.1f m, %.1f min, %.0f crossings\r\n",
+                name, u.mm / 1000.0, u.ms / 60000.0, u.crossings);
+        }
+        if (g_windowsDay) {
+            StringCchLengthW(text, ARRAYSIZE(text), &len);
+            StringCchPrintfW(text + len, ARRAYSIZE(text) - len, L"Windows used today: ~%.0f\r\n",
+                HllEstimate(g_windowsHll, HLL_BITS));
+        }
+        // Top three titles by distance; the summary is small enough to scan.
+        UINT shown[3] = { TITLE_TOPK, TITLE_TOPK, TITLE_TOPK };
+        for (UINT r = 0; r < 3; ++r) {
+            for (UINT i = 0; i < g_titleCount; ++i) {
+                if (i == shown[0] || i == shown[1]) continue;
+                if (shown[r] == TITLE_TOPK || g_titles[i].mm > g_titles[shown[r]].mm) shown[r] = i;
+            }
+            if (shown[r] == TITLE_TOPK) break;
+            StringCchLengthW(text, ARRAYSIZE(text), &len);
+            StringCchPrintfW(text + len, ARRAYSIZE(text) - len, L"  %.1f m  %s\r\n",
+                g_titles[shown[r]].mm / 1000.0, g_titles[shown[r]].title);
+        }
+        if (g_lastAlert[0]) {
+            StringCchLengthW(text, ARRAYSIZE(text), &len);
+            StringCchPrintfW(text + len, ARRAYSIZE(text) - len, L"Alert: %s\r\n", g_lastAlert);
+        }
+        if (g_lastDwell.durationMs) {
+            StringCchLengthW(text, ARRAYSIZE(text), &len);
+            StringCchPrintfW(text + len, ARRAYSIZE(text) - len, L"Last dwell: %.1f s on display %d (%s)\r\n",
+                g_lastDwell.durationMs / 1000.0, g_lastDwell.monitor + 1, g_lastDwell.app);
+        }
+        UINT top = 0;
+        for (UINT i = 1; i < g_appCount; ++i)
+            if (g_appDwell[i].ms > g_appDwell[top].ms) top = i;
+        if (g_appCount) {
+            StringCchLengthW(text, ARRAYSIZE(text), &len);
+            StringCchPrintfW(text + len, ARRAYSIZE(text) - len, L"Most dwell: %s (%.1f min)\r\n",
+                g_appDwell[top].app, g_appDwell[top].ms / 60000.0);
+        }
+        // Level 2 cells span 4x4 grid cells, about a sixteenth of the screen width.
+        UINT hx, hy;
+        if (HeatBusiest(2, &hx, &hy)) {
+            LONG vx = GetSystemMetrics(SM_XVIRTUALSCREEN), vy = GetSystemMetrics(SM_YVIRTUALSCREEN);
+            LONG vw = GetSystemMetrics(SM_CXVIRTUALSCREEN), vh = GetSystemMetrics(SM_CYVIRTUALSCREEN);
+            StringCchLengthW(text, ARRAYSIZE(text), &len);
+            StringCchPrintfW(text + len, ARRAYSIZE(text) - len, L"Busiest dwell area: %ld,%ld - %ld,%ld\r\n",
+                vx + (LONG)(hx * 4) * vw / (LONG)DWELL_GRID_X, vy + (LONG)(hy * 4) * vh / (LONG)DWELL_GRID_Y,
+                vx + (LONG)(hx * 4 + 4) * vw / (LONG)DWELL_GRID_X, vy + (LONG)(hy * 4 + 4) * vh / (LONG)DWELL_GRID_Y);
+        }
+        FittsStats all{};
+        for (UINT h = 0; h < 24; ++h) {
+            all.count += g_fittsHours[h].count;
+            all.sumTP += g_fittsHours[h].sumTP;
+            all.sumEfficiency += g_fittsHours[h].sumEfficiency;
+        }
+        if (all.count > 0.0) {
+            StringCchLengthW(text, ARRAYSIZE(text), &len);
+            StringCchPrintfW(text + len, ARRAYSIZE(text) - len,
+                L"Click-to-click: %.0f moves, %.2f bits/s, %.0f%% path efficiency\r\n",
+                all.count, all.sumTP / all.count, 100.0 * all.sumEfficiency / all.count);
+        }
+        const TremorMinute& tm = g_tremorMinutes[g_tremorMinute % TREMOR_MINUTES];
+        if (g_tremorEnabled && tm.blocks) {
+            StringCchLengthW(text, ARRAYSIZE(text), &len);
+            StringCchPrintfW(text + len, ARRAYSIZE(text) - len,
+                L"Tremor (mm/s RMS): 4-6 Hz %.2f, 6-8 Hz %.2f, 8-12 Hz %.2f\r\n",
+                std::sqrt(tm.power[0] / tm.blocks), std::sqrt(tm.power[1] / tm.blocks), std::sqrt(tm.power[2] / tm.blocks));
+        }
+    }
+#endif
+    double shellCalls = WindowSum(g_shellCalls, now);
+    if (shellCalls > 0.0) {
+        StringCchLengthW(text, ARRAYSIZE(text), &len);
+        StringCchPrintfW(text + len, ARRAYSIZE(text) - len, L"Tray updates (last hour): %.0f\r\n", shellCalls);
+    }
+#ifdef MPT_MINIMAL
+    SIZE_T privateKB = PrivateWorkingSetKB();
+    if (privateKB) {
+        StringCchLengthW(text, ARRAYSIZE(text), &len);
+        StringCchPrintfW(text + len, ARRAYSIZE(text) - len, L"Private working set: %Iu KB\r\n", privateKB);
+    }
+#endif
 
-    SetWindowTextW(hWnd, L"Mouse Path Tracker — Bob Paydar");
-    SetWindowTextW(g_hEdit, text.c_str());
+    // Replacing the text scrolls the edit control back to the top, so only
+    // replace it when it changed and put the reader back where they were.
+    static wchar_t shownText[ARRAYSIZE(text)];
+    if (wcscmp(shownText, text) == 0) return;
+    StringCchCopyW(shownText, ARRAYSIZE(shownText), text);
+    LRESULT firstLine = SendMessageW(g_hEdit, EM_GETFIRSTVISIBLELINE, 0, 0);
+    SendMessageW(g_hEdit, WM_SETREDRAW, FALSE, 0);
+    SetWindowTextW(g_hEdit, text);
+    if (firstLine > 0) SendMessageW(g_hEdit, EM_LINESCROLL, 0, firstLine);
+    SendMessageW(g_hEdit, WM_SETREDRAW, TRUE, 0);
+    InvalidateRect(g_hEdit, NULL, TRUE);
 }
 
 // Tray
+#ifndef MPT_MINIMAL
+// 3x5 glyphs for '0'-'9' and '.', one byte per row, bit 2 = left column.
+static const BYTE kGlyphRows[11][5] = {
+    { 7, 5, 5, 5, 7 }, { 2, 6, 2, 2, 7 }, { 7, 1, 7, 4, 7 }, { 7, 1, 7, 1, 7 }, { 5, 5, 7, 1, 1 },
+    { 7, 4, 7, 1, 7 }, { 7, 4, 7, 5, 7 }, { 7, 1, 1, 1, 1 }, { 7, 5, 7, 5, 7 }, { 7, 5, 7, 1, 7 },
+    { 0, 0, 0, 0, 4 },
+};
+
+// Draws text into the shared DIB and returns a new icon built from it.
+static HICON TrayRender(const wchar_t* text) {
+    int size = GetSystemMetrics(SM_CXSMICON);
+    if (size < 16) size = 16;
+    if (size > (int)TRAY_ICON_MAX) size = TRAY_ICON_MAX;
+    if (size != g_traySize) {
+        TrayIconFree();
+        BITMAPINFO bi{};
+        bi.bmiHeader.biSize = sizeof(bi.bmiHeader);
+        bi.bmiHeader.biWidth = size;
+        bi.bmiHeader.biHeight = -size; // top-down
+        bi.bmiHeader.biPlanes = 1;
+        bi.bmiHeader.biBitCount = 32;
+        bi.bmiHeader.biCompression = BI_RGB;
+        g_trayColor = CreateDIBSection(NULL, &bi, DIB_RGB_COLORS, (void**)&g_trayBits, NULL, 0);
+        static const BYTE zeroMask[TRAY_ICON_MAX * TRAY_ICON_MAX / 8] = {};
+        g_trayMask = CreateBitmap(size, size, 1, 1, zeroMask);
+        if (!g_trayColor || !g_trayMask) { TrayIconFree(); return NULL; }
+        g_traySize = size;
+    }
+
+    int scale = size / 16;
+    int width = -1;
+    for (const wchar_t* c = text; *c; ++c) width += (*c == L'.' ? 1 : 3) + 1;
+    int x = (size - width * scale) / 2, y = (size - 5 * scale) / 2;
+    for (int i = 0; i < size * size; ++i) g_trayBits[i] = 0xFF1E3A8A;
+    for (const wchar_t* c = text; *c; ++c) {
+        int glyph = (*c == L'.') ? 10 : *c - L'0';
+        int w = (*c == L'.') ? 1 : 3;
+        for (int row = 0; row < 5; ++row)
+            for (int col = 0; col < w; ++col) {
+                if (!(kGlyphRows[glyph][row] & (4 >> col))) continue;
+                for (int dy = 0; dy < scale; ++dy)
+                    for (int dx = 0; dx < scale; ++dx)
+                        g_trayBits[(y + row * scale + dy) * size + x + col * scale + dx] = 0xFFFFFFFF;
+            }
+        x += (w + 1) * scale;
+    }
+    GdiFlush();
+    ICONINFO ii{};
+    ii.fIcon = TRUE;
+    ii.hbmMask = g_trayMask;
+    ii.hbmColor = g_trayColor;
+    return CreateIconIndirect(&ii); // copies the bitmaps, so they can be reused
+}
+#endif
+
+// Every Shell_NotifyIconW call goes through here. A version 4 icon turns the
+// standard tooltip off again on any NIM_MODIFY without NIF_SHOWTIP, so it is
+// added to all of them, icon-only and balloon updates included.
+BOOL ShellNotify(DWORD message, NOTIFYICONDATA* nid) {
+#ifdef NIF_SHOWTIP
+    if (message == NIM_MODIFY) nid->uFlags |= NIF_SHOWTIP;
+#endif
+    WindowAdd(g_shellCalls, GetTickCount64(), 1.0);
+    return Shell_NotifyIconW(message, nid);
+}
+
+// UI thread, every TIMER_UI tick: one NIM_MODIFY for whatever changed and is
+// not throttled.
+void TrayTick(HWND hWnd) {
+    if (!g_inTray) return;
+    ULONGLONG now = GetTickCount64();
+    NOTIFYICONDATA nid{};
+    nid.cbSize = sizeof(nid);
+    nid.hWnd = hWnd;
+    nid.uID = TRAY_ICON_ID;
+
+    wchar_t text[ARRAYSIZE(g_trayText)];
+    double meters = g_todayMM / 1000.0;
+    if (meters < 1000.0) StringCchPrintfW(text, ARRAYSIZE(text), L"%u", (UINT)meters);
+    else if (meters < 9950.0) StringCchPrintfW(text, ARRAYSIZE(text), L"%.1f", meters / 1000.0);
+    else StringCchPrintfW(text, ARRAYSIZE(text), L"%.0f", (std::min)(meters / 1000.0, 999.0)); // rounds, so 9.95 km shows 10
+    HICON icon = NULL;
+#ifndef MPT_MINIMAL
+    if (wcscmp(text, g_trayText) != 0 && (!g_trayModifiedMs || now - g_trayModifiedMs >= TRAY_MODIFY_MIN_MS)) {
+        icon = TrayRender(text);
+        if (icon) {
+            nid.uFlags |= NIF_ICON;
+            nid.hIcon = icon;
+        }
+    }
+#endif
+
+    double seconds = (double)(g_rateMM[RATE_MINUTE].bucketMs * g_rateMM[RATE_MINUTE].buckets) / 1000.0;
+    StringCchPrintfW(nid.szTip, ARRAYSIZE(nid.szTip), L"Mouse Path Tracker%s\nToday: %.0f m\nTotal: %.3f km\nLast minute: %.1f m/min",
+        g_running ? L"" : L" (paused)", meters, g_totalMM / 1000000.0,
+        WindowSum(g_rateMM[RATE_MINUTE], now) / 1000.0 * 60.0 / seconds);
+    if (wcscmp(nid.szTip, g_trayTip) != 0 && (!g_trayTipMs || now - g_trayTipMs >= TRAY_TIP_MIN_MS))
+        nid.uFlags |= NIF_TIP;
+    if (!nid.uFlags) return;
+
+    ShellNotify(NIM_MODIFY, &nid);
+    if (nid.uFlags & NIF_TIP) {
+        StringCchCopyW(g_trayTip, ARRAYSIZE(g_trayTip), nid.szTip);
+        g_trayTipMs = now;
+    }
+    if (!icon) return;
+    if (g_trayIcon) DestroyIcon(g_trayIcon);
+    g_trayIcon = icon;
+    StringCchCopyW(g_trayText, ARRAYSIZE(g_trayText), text);
+    g_trayModifiedMs = now;
+
+    // Handle-leak check: report each new peak of GDI objects.
+    DWORD gdi = GetGuiResources(GetCurrentProcess(), GR_GDIOBJECTS);
+    if (gdi > g_gdiPeak) {
+        g_gdiPeak = gdi;
+        wchar_t buf[96];
+        StringCchPrintfW(buf, ARRAYSIZE(buf), L"MousePathTracker tray: %lu GDI objects (new max)\n", gdi);
+        OutputDebugStringW(buf);
+    }
+}
+
+#ifndef MPT_MINIMAL
+// Releases the shared bitmaps (on an icon size change and at exit).
+void TrayIconFree() {
+    if (g_trayColor) DeleteObject(g_trayColor);
+    if (g_trayMask) DeleteObject(g_trayMask);
+    g_trayColor = NULL;
+    g_trayMask = NULL;
+    g_trayBits = NULL;
+    g_traySize = 0;
+}
+#endif
+
 void EnsureTrayIcon(HWND hWnd, bool add) {
     NOTIFYICONDATA nid{};
     nid.cbSize = sizeof(nid);
     nid.hWnd = hWnd;
     nid.uID = TRAY_ICON_ID;
     nid.uFlags = NIF_MESSAGE | NIF_ICON | NIF_TIP;
+#ifdef NIF_SHOWTIP
+    nid.uFlags |= NIF_SHOWTIP; // version 4 icons show no standard tooltip without it
+#endif
     nid.uCallbackMessage = WM_TRAYICON;
     if (!g_hIcon) g_hIcon = LoadIcon(NULL, IDI_APPLICATION);
     nid.hIcon = g_hIcon;
     StringCchCopyW(nid.szTip, ARRAYSIZE(nid.szTip), L"Mouse Path Tracker — Bob Paydar");
     if (add) {
-        Shell_NotifyIconW(NIM_ADD, &nid);
+        ShellNotify(NIM_ADD, &nid);
 #ifdef NOTIFYICON_VERSION_4
         nid.uVersion = NOTIFYICON_VERSION_4;
-        Shell_NotifyIconW(NIM_SETVERSION, &nid);
+        ShellNotify(NIM_SETVERSION, &nid);
 #endif
     }
     else {
-        Shell_NotifyIconW(NIM_DELETE, &nid);
+        ShellNotify(NIM_DELETE, &nid);
+        if (g_trayIcon) DestroyIcon(g_trayIcon);
+        g_trayIcon = NULL;
     }
+    g_trayText[0] = L'\0'; // the next tick draws the live icon and tooltip
+    g_trayModifiedMs = 0;
+    g_trayTip[0] = L'\0';
+    g_trayTipMs = 0;
 }
 
 void MinimizeToTray(HWND hWnd) {
@@ -204,42 +2027,499 @@ HMENU BuildTrayMenu() {
     AppendMenuW(hMenu, MF_STRING, 4001, L"&Restore");
     AppendMenuW(hMenu, MF_STRING, 4002, g_running ? L"&Pause" : L"&Start");
     AppendMenuW(hMenu, MF_STRING, 4003, L"&Reset");
+    AppendMenuW(hMenu, MF_STRING, 4005, L"&Export history");
+#ifndef MPT_MINIMAL
+    AppendMenuW(hMenu, MF_STRING | (g_hGraph && IsWindowVisible(g_hGraph) ? MF_CHECKED : MF_UNCHECKED), 4006, L"&Graph");
+    AppendMenuW(hMenu, MF_STRING | (g_hHeat && IsWindowVisible(g_hHeat) ? MF_CHECKED : MF_UNCHECKED), 4007, L"&Heatmap");
+#endif
     AppendMenuW(hMenu, MF_SEPARATOR, 0, NULL);
     AppendMenuW(hMenu, MF_STRING, 4004, L"E&xit");
     return hMenu;
 }
 
 // INI
-std::wstring GetIniPath() {
-    wchar_t exePath[MAX_PATH];
-    GetModuleFileNameW(NULL, exePath, MAX_PATH);
-    std::wstring s = exePath;
-    size_t pos = s.find_last_of(L"\\/");
-    std::wstring dir = (pos == std::wstring::npos) ? L"" : s.substr(0, pos + 1);
-    size_t dot = s.find_last_of(L".");
-    std::wstring base = (dot == std::wstring::npos) ? s : s.substr(0, dot);
-    size_t bslash = base.find_last_of(L"\\/");
-    std::wstring fname = (bslash == std::wstring::npos) ? base : base.substr(bslash + 1);
-    return dir + fname + L".ini";
+// Computed once (wWinMain calls it before any thread starts) and reused.
+const wchar_t* GetIniPath() {
+    static wchar_t path[MAX_PATH] = L"";
+    if (path[0]) return path;
+    GetModuleFileNameW(NULL, path, MAX_PATH - 4);
+    wchar_t* slash = wcsrchr(path, L'\\');
+    wchar_t* fslash = wcsrchr(path, L'/');
+    if (fslash > slash) slash = fslash;
+    wchar_t* dot = wcsrchr(path, L'.');
+    if (!dot || dot < slash) dot = path + wcslen(path);
+    StringCchCopyW(dot, MAX_PATH - (dot - path), L".ini");
+    return path;
 }
 
+// UI thread: snapshot the totals and hand the write to the worker.
 void SaveState() {
-    std::wstring ini = GetIniPath();
+    if (!g_stateLoaded) return; // never overwrite saved totals with a partial count
+    RollupAdvance();
+    HostPublish();
+    EnterCriticalSection(&g_workLock);
+    g_saveSnapshot.totalMM = g_totalMM;
+    g_saveSnapshot.injectedMM = g_injectedMM;
+    g_saveSnapshot.running = g_running;
+    g_saveSnapshot.todayKey = g_todayKey;
+    g_saveSnapshot.todayMM = g_todayMM;
+#ifndef MPT_MINIMAL
+    g_saveSnapshot.fittsAppCount = g_fittsAppCount;
+    for (UINT i = 0; i < g_fittsAppCount; ++i) g_saveSnapshot.fittsApps[i] = g_fittsApps[i];
+    for (UINT h = 0; h < 24; ++h) g_saveSnapshot.fittsHours[h] = g_fittsHours[h];
+    g_saveSnapshot.appCount = g_appCount;
+    for (UINT i = 0; i < g_appCount; ++i) g_saveSnapshot.appDwell[i] = g_appDwell[i];
+    g_saveSnapshot.titleCount = g_titleCount;
+    for (UINT i = 0; i < g_titleCount; ++i) g_saveSnapshot.titles[i] = g_titles[i];
+    g_saveSnapshot.windowsDay = g_windowsDay;
+    for (UINT i = 0; i < HLL_REGISTERS; ++i) g_saveSnapshot.windowsHll[i] = g_windowsHll[i];
+    g_saveSnapshot.monitorUsageCount = g_monitorUsageCount;
+    for (UINT i = 0; i < g_monitorUsageCount; ++i) g_saveSnapshot.monitorUsage[i] = g_monitorUsage[i];
+    for (UINT i = 0; i < g_zoneCount; ++i) {
+        g_saveSnapshot.zoneMM[i] = g_zones[i].mm;
+        g_saveSnapshot.zoneMs[i] = g_zones[i].ms;
+    }
+#endif
+    if (g_sealedKey) {
+        g_saveSnapshot.sealedKey = g_sealedKey;
+        g_saveSnapshot.sealedMM = g_sealedMM;
+        g_sealedKey = 0;
+    }
+    LeaveCriticalSection(&g_workLock);
+    WorkSubmit(WORK_SAVE);
+}
+
+// Worker: write one snapshot. History pruning continues over later saves.
+// Keys whose value has not changed since the last save are not rewritten, so
+// an idle minute writes nothing.
+static void PersistSnapshot(const SaveSnapshot& snap) {
+    static bool prunePending = true;
+    static double savedTotalMM = -1.0, savedInjectedMM = -1.0, savedTodayMM = -1.0;
+    static int savedRunning = -1;
+    static DWORD savedTodayKey = 0;
+    const wchar_t* ini = GetIniPath();
+#ifndef MPT_MINIMAL
+    if (g_hostMode) {
+        // Only the elected instance writes; everyone else just publishes.
+        if (!g_hostOwner && g_hostMutex) {
+            DWORD w = WaitForSingleObject(g_hostMutex, 0);
+            g_hostOwner = (w == WAIT_OBJECT_0 || w == WAIT_ABANDONED);
+        }
+        if (g_hostOwner) HostPersist(ini);
+        return;
+    }
+#endif
     wchar_t buf[64];
-    StringCchPrintfW(buf, 64, L"%.8f", g_totalMM);
-    WritePrivateProfileStringW(L"MousePathTracker", L"TotalMM", buf, ini.c_str());
-    WritePrivateProfileStringW(L"MousePathTracker", L"Running", g_running ? L"1" : L"0", ini.c_str());
+    if (snap.totalMM != savedTotalMM) {
+        StringCchPrintfW(buf, 64, L"%.8f", snap.totalMM);
+        WritePrivateProfileStringW(L"MousePathTracker", L"TotalMM", buf, ini);
+        savedTotalMM = snap.totalMM;
+    }
+    if ((int)snap.running != savedRunning) {
+        WritePrivateProfileStringW(L"MousePathTracker", L"Running", snap.running ? L"1" : L"0", ini);
+        savedRunning = (int)snap.running;
+    }
+    if (snap.injectedMM != savedInjectedMM) {
+        StringCchPrintfW(buf, 64, L"%.8f", snap.injectedMM);
+        WritePrivateProfileStringW(L"MousePathTracker", L"InjectedMM", buf, ini);
+        savedInjectedMM = snap.injectedMM;
+    }
+    if (snap.sealedKey) {
+        HistoryWriteDay(snap.sealedKey, snap.sealedMM);
+        prunePending = true;
+    }
+    if (snap.todayKey && (snap.todayKey != savedTodayKey || snap.todayMM != savedTodayMM)) {
+        HistoryWriteDay(snap.todayKey, snap.todayMM);
+        savedTodayKey = snap.todayKey;
+        savedTodayMM = snap.todayMM;
+    }
+#ifndef MPT_MINIMAL
+    if (g_zoneCount) ZonesPersist(snap, ini);
+    MonitorsPersist(snap, ini);
+    TitlesPersist(snap, ini);
+    DwellPersist(snap, ini);
+    FittsPersist(snap, ini);
+#endif
+    if (prunePending) prunePending = HistoryPrune(ini);
 }
 
+// Worker: results land in g_loadedState.
 void LoadState() {
-    std::wstring ini = GetIniPath();
+    const wchar_t* ini = GetIniPath();
+#ifndef MPT_MINIMAL
+    if (GetPrivateProfileIntW(L"MousePathTracker", L"HostAggregator", 0, ini) != 0)
+        g_hostMode = HostAttach(ini);
+#endif
     wchar_t buf[128];
-    GetPrivateProfileStringW(L"MousePathTracker", L"TotalMM", L"0", buf, 128, ini.c_str());
-    g_totalMM = _wtof(buf);
-    GetPrivateProfileStringW(L"MousePathTracker", L"Running", L"1", buf, 128, ini.c_str());
-    g_running = (buf[0] != L'0');
+    GetPrivateProfileStringW(L"MousePathTracker", L"TotalMM", L"0", buf, 128, ini);
+    g_loadedState.totalMM = _wtof(buf);
+    GetPrivateProfileStringW(L"MousePathTracker", L"Running", L"1", buf, 128, ini);
+    g_loadedState.running = (buf[0] != L'0');
+    g_historyDays = GetPrivateProfileIntW(L"MousePathTracker", L"HistoryDays", 365, ini);
+    if (g_historyDays == 0) g_historyDays = 1;
+    if (g_historyDays > HISTORY_INDEX_DAYS) g_historyDays = HISTORY_INDEX_DAYS;
+    g_historyArchive = GetPrivateProfileIntW(L"MousePathTracker", L"HistoryArchive", 0, ini) != 0;
+#ifndef MPT_MINIMAL
+    g_tremorEnabled = GetPrivateProfileIntW(L"MousePathTracker", L"Tremor", 0, ini) != 0;
+    AlertsLoad(ini);
+#endif
+    SYSTEMTIME st; GetLocalTime(&st);
+    wchar_t day[16];
+    g_loadedState.dayKey = DayKey(st);
+    StringCchPrintfW(day, ARRAYSIZE(day), L"%lu", g_loadedState.dayKey);
+    GetPrivateProfileStringW(L"History", day, L"0", buf, 128, ini);
+    g_loadedState.dayMM = _wtof(buf);
+#ifndef MPT_MINIMAL
+    // HostAttach filled the slot from [HostUsers], or kept what this user's
+    // previous session left in it.
+    if (g_hostMode) {
+        g_loadedState.totalMM = g_hostSlot->totalMM;
+        g_loadedState.running = g_hostSlot->running != 0;
+    }
+#endif
+    if (!g_hostMode) {
+        GetPrivateProfileStringW(L"MousePathTracker", L"InjectedMM", L"0", buf, 128, ini);
+        g_loadedState.injectedMM = _wtof(buf);
+        HistoryIndexLoad(ini);
+#ifndef MPT_MINIMAL
+        ZonesLoad(ini);
+        MonitorsLoad(ini);
+        TitlesLoad(ini);
+        DwellLoad(ini);
+        FittsLoad(ini);
+#endif
+    }
+}
+
+// UI thread: movement counted while loading is added on top of the saved total.
+void ApplyLoadedState() {
+    if (g_stateLoaded) return;
+    WaitForSingleObject(g_loadedEvent, INFINITE);
+    RollupAdvance(); // fold movement counted while loading before adding the saved total
+    g_totalMM += g_loadedState.totalMM;
+    g_rolledMM += g_loadedState.totalMM;
+#ifndef MPT_MINIMAL
+    g_titleRolledMM += g_loadedState.totalMM;
+#endif
+    g_injectedMM += g_loadedState.injectedMM;
+    if (g_loadedState.dayKey == g_todayKey) g_todayMM += g_loadedState.dayMM;
+    g_running = g_loadedState.running;
+    ZonesBuildGrid();
+    MonitorsResolve();
+    g_stateLoaded = true;
+    HostPublish();
+#ifdef MPT_MINIMAL
+    // Startup pages are not needed again; let the thin client reclaim them.
+    SetProcessWorkingSetSize(GetCurrentProcess(), (SIZE_T)-1, (SIZE_T)-1);
+#endif
+}
+
+static double StartupElapsedMs() {
+    LARGE_INTEGER now, freq;
+    QueryPerformanceCounter(&now);
+    QueryPerformanceFrequency(&freq);
+    return (double)(now.QuadPart - g_startQpc.QuadPart) * 1000.0 / (double)freq.QuadPart;
+}
+
+static void ReportStartup() {
+    static bool reported = false;
+    if (reported || !g_stateLoaded || g_startupPaintMs < 0.0) return;
+    reported = true;
+    wchar_t buf[160];
+    StringCchPrintfW(buf, ARRAYSIZE(buf),
+        L"MousePathTracker startup: hook %.2f ms, first paint %.2f ms, state loaded %.2f ms\n",
+        g_startupHookMs, g_startupPaintMs, g_startupLoadMs);
+    OutputDebugStringW(buf);
+}
+
+// Worker
+static const wchar_t* const kWorkNames[WORK_KINDS] = { L"load", L"save", L"export", L"stop" };
+
+// Runs the oldest pending job; returns false once the stop job has run.
+static bool WorkRunNext(bool wait) {
+    static ExportSnapshot exportSnap;
+    EnterCriticalSection(&g_workLock);
+    while (wait && g_workCount == 0) SleepConditionVariableCS(&g_workReady, &g_workLock, INFINITE);
+    if (g_workCount == 0) { LeaveCriticalSection(&g_workLock); return true; }
+    UINT kind = g_workOrder[0];
+    for (UINT i = 1; i < g_workCount; ++i) g_workOrder[i - 1] = g_workOrder[i];
+    --g_workCount;
+    g_workPending[kind] = false;
+    SaveSnapshot saveSnap{};
+    if (kind == WORK_SAVE) {
+        saveSnap = g_saveSnapshot;
+        g_saveSnapshot.sealedKey = 0;
+    }
+    if (kind == WORK_EXPORT) exportSnap = g_exportSnapshot;
+    LeaveCriticalSection(&g_workLock);
+
+    LARGE_INTEGER t0, t1, freq;
+    QueryPerformanceCounter(&t0);
+    switch (kind) {
+    case WORK_LOAD:
+        LoadState();
+        g_startupLoadMs = StartupElapsedMs();
+        SetEvent(g_loadedEvent);
+        if (g_hMain) PostMessageW(g_hMain, WM_STATE_LOADED, 0, 0);
+        break;
+    case WORK_SAVE: PersistSnapshot(saveSnap); break;
+    case WORK_EXPORT: ExportHistory(exportSnap); break;
+    case WORK_STOP: HostDetach(); break;
+    }
+    QueryPerformanceCounter(&t1);
+    QueryPerformanceFrequency(&freq);
+
+    // Per-stage latency: report each new worst case.
+    double ms = (double)(t1.QuadPart - t0.QuadPart) * 1000.0 / (double)freq.QuadPart;
+    if (ms > g_workMaxMs[kind]) {
+        g_workMaxMs[kind] = ms;
+        wchar_t buf[96];
+        StringCchPrintfW(buf, ARRAYSIZE(buf), L"MousePathTracker worker: %s took %.2f ms (new max)\n", kWorkNames[kind], ms);
+        OutputDebugStringW(buf);
+    }
+    return kind != WORK_STOP;
+}
+
+static DWORD WINAPI WorkThreadProc(LPVOID) {
+    // The startup load runs at below-normal priority; everything after it in
+    // background mode, which also lowers I/O priority.
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+    if (!WorkRunNext(true)) return 0;
+    SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+    while (WorkRunNext(true)) {}
+    return 0;
+}
+
+static void WorkEnqueue(UINT kind) {
+    EnterCriticalSection(&g_workLock);
+    if (!g_workPending[kind]) {
+        g_workPending[kind] = true;
+        g_workOrder[g_workCount++] = kind;
+    }
+    LeaveCriticalSection(&g_workLock);
+}
+
+void WorkStart() {
+    InitializeCriticalSection(&g_workLock);
+    g_loadedEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+    WorkEnqueue(WORK_LOAD);
+#ifndef MPT_MINIMAL
+    g_workThread = CreateThread(NULL, 0, WorkThreadProc, NULL, 0, NULL);
+#endif
+    g_workInline = (g_workThread == NULL);
+    if (g_workInline) {
+        // The load is about to block this thread; a low-level hook on it would
+        // stall every pointer on the desktop until it finishes.
+        if (g_hook) { UnhookWindowsHookEx(g_hook); g_hook = NULL; }
+        WorkRunNext(false);
+    }
+}
+
+void WorkSubmit(UINT kind) {
+    WorkEnqueue(kind);
+    if (!g_workInline) WakeConditionVariable(&g_workReady);
+    else while (g_workCount && WorkRunNext(false)) {}
+}
+
+// Drains pending jobs (the final save included), then releases host resources.
+void WorkStop() {
+    WorkSubmit(WORK_STOP);
+    if (g_workThread) {
+        WaitForSingleObject(g_workThread, INFINITE);
+        CloseHandle(g_workThread);
+        g_workThread = NULL;
+    }
+    DeleteCriticalSection(&g_workLock);
+    if (g_loadedEvent) { CloseHandle(g_loadedEvent); g_loadedEvent = NULL; }
+}
+
+#ifndef MPT_MINIMAL
+// Host aggregator
+static ULONGLONG HostNow() {
+    FILETIME ft; GetSystemTimeAsFileTime(&ft);
+    return ((ULONGLONG)ft.dwHighDateTime << 32) | ft.dwLowDateTime;
+}
+
+static bool HostSlotStale(const HostSlot& s, ULONGLONG now) {
+    const ULONGLONG limit = (ULONGLONG)HOST_STALE_SECONDS * 10000000ULL;
+    return s.heartbeat > now || now - s.heartbeat > limit;
+}
+
+bool HostAttach(const wchar_t* ini) {
+    wchar_t path[MAX_PATH];
+    StringCchCopyW(path, ARRAYSIZE(path), ini);
+    wchar_t* dot = wcsrchr(path, L'.');
+    if (dot) StringCchCopyW(dot, ARRAYSIZE(path) - (dot - path), L".host");
+    g_hostFile = CreateFileW(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+        NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (g_hostFile == INVALID_HANDLE_VALUE) { g_hostFile = NULL; return false; }
+    // Unnamed mapping of a shared file: needs no SeCreateGlobalPrivilege, yet all
+    // sessions on the host see the same pages.
+    g_hostMap = CreateFileMappingW(g_hostFile, NULL, PAGE_READWRITE, 0, sizeof(HostTable), NULL);
+    if (g_hostMap) g_hostTable = (HostTable*)MapViewOfFile(g_hostMap, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(HostTable));
+    if (!g_hostTable) { HostDetach(); return false; }
+
+    wchar_t user[64] = L"";
+    DWORD userLen = ARRAYSIZE(user);
+    GetUserNameW(user, &userLen);
+    DWORD sessionId = 0;
+    ProcessIdToSessionId(GetCurrentProcessId(), &sessionId);
+
+    // Prefer this user's abandoned slot, otherwise take the first free one.
+    // Saved total for a fresh slot; read before claiming so the slot goes live
+    // with totalMM == persistedMM and the owner never sees a half-set base.
+    wchar_t saved[64];
+    GetPrivateProfileStringW(L"HostUsers", user, L"", saved, ARRAYSIZE(saved), ini);
+    double savedMM = 0.0;
+    int savedRunning = 1;
+    swscanf_s(saved, L"%lf,%d", &savedMM, &savedRunning);
+
+    ULONGLONG now = HostNow();
+    for (int pass = 0; pass < 2 && !g_hostSlot; ++pass) {
+        for (UINT i = 0; i < HOST_MAX_SESSIONS && !g_hostSlot; ++i) {
+            HostSlot& s = g_hostTable->slots[i];
+            LONG st = s.state;
+            bool take = (pass == 0)
+                ? ((st == HOST_SLOT_CLOSED || (st == HOST_SLOT_LIVE && HostSlotStale(s, now))) && lstrcmpiW(s.user, user) == 0)
+                : (st == HOST_SLOT_FREE);
+            if (take && InterlockedCompareExchange(&s.state, HOST_SLOT_CLAIMING, st) == st) {
+                if (pass == 1) {
+                    s.totalMM = s.persistedMM = savedMM;
+                    s.running = s.persistedRunning = savedRunning ? 1 : 0;
+                }
+                StringCchCopyW(s.user, ARRAYSIZE(s.user), user);
+                s.sessionId = sessionId;
+                s.pid = GetCurrentProcessId();
+                s.heartbeat = now;
+                InterlockedExchange(&s.state, HOST_SLOT_LIVE);
+                g_hostSlot = &s;
+            }
+        }
+    }
+    if (!g_hostSlot) { HostDetach(); return false; }
+
+    // Interactive users may wait on and release the persister mutex, nothing
+    // more; the OWNER RIGHTS entry takes away the creator's implicit right to
+    // change the DACL. SYSTEM and administrators keep full control.
+    void* sd = NULL;
+    if (ConvertStringSecurityDescriptorToSecurityDescriptorW(
+            L"D:P(A;;0x00100001;;;IU)(A;;0x00100001;;;OW)(A;;GA;;;SY)(A;;GA;;;BA)", SDDL_REVISION_1, &sd, NULL)) {
+        SECURITY_ATTRIBUTES sa{ sizeof(sa), sd, FALSE };
+        g_hostMutex = CreateMutexExW(&sa, L"Global\\MousePathTrackerHostPersist", 0, SYNCHRONIZE | MUTEX_MODIFY_STATE);
+        LocalFree(sd);
+    }
+    return true;
+}
+
+void HostPublish() {
+    if (!g_stateLoaded || !g_hostSlot) return;
+    g_hostSlot->totalMM = g_totalMM;
+    g_hostSlot->running = g_running ? 1 : 0;
+    g_hostSlot->heartbeat = HostNow();
+}
+
+static HostUser* HostFindUser(HostUser* users, UINT& count, const wchar_t* name) {
+    for (UINT i = 0; i < count; ++i)
+        if (lstrcmpiW(users[i].name, name) == 0) return &users[i];
+    if (count == HOST_MAX_USERS) return nullptr;
+    HostUser& u = users[count++];
+    StringCchCopyW(u.name, ARRAYSIZE(u.name), name);
+    u.mm = 0.0;
+    u.running = 1;
+    return &u;
+}
+
+// Worker, elected instance only: folds every slot's unsaved movement into
+// [HostUsers] with one section read and one section write, or no I/O at all
+// when nothing changed since the last pass.
+void HostPersist(const wchar_t* ini) {
+    if (!g_hostTable) return;
+    ULONGLONG now = HostNow();
+    bool changed = false;
+    for (UINT i = 0; i < HOST_MAX_SESSIONS && !changed; ++i) {
+        const HostSlot& s = g_hostTable->slots[i];
+        LONG st = s.state;
+        if (st != HOST_SLOT_LIVE && st != HOST_SLOT_CLOSED) continue;
+        changed = s.totalMM != s.persistedMM || s.running != s.persistedRunning
+            || st == HOST_SLOT_CLOSED || HostSlotStale(s, now);
+    }
+    if (!changed) return;
+
+    const DWORD cch = HOST_MAX_USERS * 96;
+    HostUser* users = (HostUser*)HeapAlloc(GetProcessHeap(), 0, HOST_MAX_USERS * sizeof(HostUser));
+    wchar_t* section = ReadIniSection(L"HostUsers", cch, ini);
+    if (!users || !section) {
+        if (users) HeapFree(GetProcessHeap(), 0, users);
+        if (section) HeapFree(GetProcessHeap(), 0, section);
+        return;
+    }
+    UINT count = 0;
+    for (const wchar_t* e = section; *e && count < HOST_MAX_USERS; e += wcslen(e) + 1) {
+        const wchar_t* eq = wcschr(e, L'=');
+        if (!eq || eq == e) continue;
+        HostUser& u = users[count];
+        StringCchCopyNW(u.name, ARRAYSIZE(u.name), e, eq - e);
+        int running = 1;
+        if (swscanf_s(eq + 1, L"%lf,%d", &u.mm, &running) >= 1) {
+            u.running = running ? 1 : 0;
+            ++count;
+        }
+    }
+
+    LONG folded[HOST_MAX_SESSIONS];
+    for (UINT i = 0; i < HOST_MAX_SESSIONS; ++i) {
+        HostSlot& s = g_hostTable->slots[i];
+        LONG st = folded[i] = s.state;
+        if (st != HOST_SLOT_LIVE && st != HOST_SLOT_CLOSED) continue;
+        HostUser* u = HostFindUser(users, count, s.user);
+        if (!u) { folded[i] = HOST_SLOT_CLAIMING; continue; }   // table full: keep the slot
+        HostFold(*u, s.totalMM, s.running, s.persistedMM, s.persistedRunning);
+    }
+
+    size_t used = 0;
+    for (UINT i = 0; i < count; ++i) {
+        if (FAILED(StringCchPrintfW(section + used, cch - 1 - used, L"%s=%.8f,%ld", users[i].name, users[i].mm, users[i].running)))
+            break;
+        used += wcslen(section + used) + 1;
+    }
+    section[used] = L'\0';
+    WritePrivateProfileSectionW(L"HostUsers", section, ini);
+    HeapFree(GetProcessHeap(), 0, section);
+    HeapFree(GetProcessHeap(), 0, users);
+
+    // Closed and long-silent slots are saved one last time, then recycled,
+    // unless their state moved on since they were folded.
+    for (UINT i = 0; i < HOST_MAX_SESSIONS; ++i) {
+        HostSlot& s = g_hostTable->slots[i];
+        LONG st = folded[i];
+        if ((st == HOST_SLOT_LIVE || st == HOST_SLOT_CLOSED) && &s != g_hostSlot
+            && (st == HOST_SLOT_CLOSED || HostSlotStale(s, now)))
+            InterlockedCompareExchange(&s.state, HOST_SLOT_FREE, st);
+    }
 }
 
+void HostDetach() {
+    if (g_hostSlot) {
+        HostPublish();
+        InterlockedExchange(&g_hostSlot->state, HOST_SLOT_CLOSED);
+        if (g_hostOwner) {
+            HostPersist(GetIniPath());
+            InterlockedCompareExchange(&g_hostSlot->state, HOST_SLOT_FREE, HOST_SLOT_CLOSED);
+        }
+        g_hostSlot = nullptr;
+    }
+    if (g_hostMutex) {
+        if (g_hostOwner) ReleaseMutex(g_hostMutex);
+        CloseHandle(g_hostMutex);
+        g_hostMutex = NULL;
+    }
+    g_hostOwner = false;
+    if (g_hostTable) { UnmapViewOfFile(g_hostTable); g_hostTable = nullptr; }
+    if (g_hostMap) { CloseHandle(g_hostMap); g_hostMap = NULL; }
+    if (g_hostFile) { CloseHandle(g_hostFile); g_hostFile = NULL; }
+}
+#endif
+
 // Window creation
 static void CreateChildControls(HWND hWnd) {
     HFONT hFont = (HFONT)GetStockObject(DEFAULT_GUI_FONT);
@@ -255,10 +2535,95 @@ static void ResizeClient(HWND hWnd) {
     MoveWindow(g_hEdit, padding, padding, rc.right - 2 * padding, rc.bottom - 2 * padding, TRUE);
 }
 
+// PGO training
+// "/pgo-train": no window, no hook, no INI. Replays a fixed synthetic trace
+// at 1 kHz through LowLevelMouseProc and the UI-tick consumers: eased
+// point-to-point moves with +-1 px jitter, a click at each target, then a
+// pause. Appends the per-event cost to <name>-pgo.txt so instrumented,
+// optimized and plain builds can be compared.
+static UINT PgoRandom(UINT& state) {
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+static int PgoTrain() {
+    enum : UINT { PGO_EVENTS = 2000000, PGO_TICK_MS = 200 };
+    g_stateLoaded = true;
+    g_running = true;
+#ifndef MPT_MINIMAL
+    g_tremorEnabled = true;
+#endif
+    EnumerateMonitors();
+    LONG vx = GetSystemMetrics(SM_XVIRTUALSCREEN), vy = GetSystemMetrics(SM_YVIRTUALSCREEN);
+    LONG vw = (std::max)(GetSystemMetrics(SM_CXVIRTUALSCREEN), 1), vh = (std::max)(GetSystemMetrics(SM_CYVIRTUALSCREEN), 1);
+
+    UINT seed = 12345;
+    DWORD time = 0;
+    POINT from{ vx + vw / 2, vy + vh / 2 };
+    UINT events = 0;
+    LARGE_INTEGER t0, t1, freq;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&t0);
+    while (events < PGO_EVENTS) {
+        POINT to{ vx + (LONG)(PgoRandom(seed) % (UINT)vw), vy + (LONG)(PgoRandom(seed) % (UINT)vh) };
+        UINT steps = 100 + PgoRandom(seed) % 400;
+        for (UINT i = 1; i <= steps && events < PGO_EVENTS; ++i, ++events) {
+            double t = (double)i / steps, e = t * t * (3.0 - 2.0 * t);
+            MSLLHOOKSTRUCT ms{};
+            ms.pt.x = from.x + (LONG)((to.x - from.x) * e) + (LONG)(PgoRandom(seed) % 3) - 1;
+            ms.pt.y = from.y + (LONG)((to.y - from.y) * e) + (LONG)(PgoRandom(seed) % 3) - 1;
+            ms.time = ++time;
+            g_replayQpc = (LONGLONG)time * g_qpcFreq / 1000;
+            LowLevelMouseProc(HC_ACTION, WM_MOUSEMOVE, (LPARAM)&ms);
+            if (time % PGO_TICK_MS == 0) {
+                RollupAdvance(); FittsDrain(); MonitorsTick(); TremorDrain();
+            }
+        }
+        MSLLHOOKSTRUCT click{};
+        click.pt = to;
+        click.time = ++time;
+        g_replayQpc = (LONGLONG)time * g_qpcFreq / 1000;
+        LowLevelMouseProc(HC_ACTION, WM_LBUTTONDOWN, (LPARAM)&click);
+        time += 50 + PgoRandom(seed) % 500;
+        from = to;
+    }
+    QueryPerformanceCounter(&t1);
+    g_replayQpc = 0;
+    double ns = (double)(t1.QuadPart - t0.QuadPart) * 1e9 / (double)freq.QuadPart / events;
+
+    wchar_t path[MAX_PATH];
+    StringCchCopyW(path, ARRAYSIZE(path), GetIniPath());
+    wchar_t* dot = wcsrchr(path, L'.');
+    if (dot) StringCchCopyW(dot, ARRAYSIZE(path) - (dot - path), L"-pgo.txt");
+    SYSTEMTIME st; GetLocalTime(&st);
+    char line[128];
+    StringCchPrintfA(line, ARRAYSIZE(line), "%04u-%02u-%02u %02u:%02u events=%u ns_per_event=%.1f\r\n",
+        st.wYear, st.wMonth, st.wDay, st.wHour, st.wMinute, events, ns);
+    HANDLE f = CreateFileW(path, FILE_APPEND_DATA, FILE_SHARE_READ, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (f != INVALID_HANDLE_VALUE) {
+        DWORD written = 0;
+        WriteFile(f, line, (DWORD)strlen(line), &written, NULL);
+        CloseHandle(f);
+    }
+    return 0;
+}
+
 // WinMain
-int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int nCmdShow) {
+int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR cmdLine, int nCmdShow) {
+    QueryPerformanceCounter(&g_startQpc);
+    LARGE_INTEGER freq;
+    QueryPerformanceFrequency(&freq);
+    g_qpcFreq = freq.QuadPart;
     SetProcessDpiAwarenessContext(DPI_AWARENESS_CONTEXT_PER_MONITOR_AWARE_V2);
     g_hInst = hInstance;
+    if (cmdLine && wcsstr(cmdLine, L"/pgo-train")) return PgoTrain();
+
+#ifndef MPT_MINIMAL
+    // Track from the first moment; metrics fall back to the primary display
+    // until monitors are enumerated.
+    g_hook = SetWindowsHookExW(WH_MOUSE_LL, LowLevelMouseProc, GetModuleHandleW(NULL), 0);
+    g_startupHookMs = StartupElapsedMs();
+#endif
 
     WNDCLASSEXW wcex{};
     wcex.cbSize = sizeof(WNDCLASSEXW);
@@ -272,18 +2637,26 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int nCmdShow) {
     wcex.hIconSm = LoadIcon(NULL, IDI_APPLICATION);
     if (!RegisterClassExW(&wcex)) return 0;
 
-    // Fixed window: caption + system menu, no resize, no maximize
+    // Fixed window: caption + system menu, no resize, no maximize. Tall enough
+    // for the summary lines of a multi-monitor desk; the rest scrolls.
     DWORD style = WS_OVERLAPPED | WS_CAPTION | WS_SYSMENU | WS_MINIMIZEBOX;
     g_hMain = CreateWindowExW(0, wcex.lpszClassName, L"Mouse Path Tracker — Bob Paydar",
-        style, CW_USEDEFAULT, 0, 520, 260, NULL, NULL, hInstance, NULL);
+        style, CW_USEDEFAULT, 0, 560, 440, NULL, NULL, hInstance, NULL);
     if (!g_hMain) return 0;
 
+    GetIniPath();
+    WorkStart();
+    if (!g_workThread) ApplyLoadedState();
+    // Without a worker (always so under MPT_MINIMAL) the INI was just read on
+    // this thread with no hook installed; hook now that the load is done.
+    if (!g_hook) {
+        g_hook = SetWindowsHookExW(WH_MOUSE_LL, LowLevelMouseProc, GetModuleHandleW(NULL), 0);
+        g_startupHookMs = StartupElapsedMs();
+    }
+
     ShowWindow(g_hMain, nCmdShow);
     UpdateWindow(g_hMain);
-
-    EnumerateMonitors();
-    LoadState();
-    g_hook = SetWindowsHookExW(WH_MOUSE_LL, LowLevelMouseProc, GetModuleHandleW(NULL), 0);
+    PostMessageW(g_hMain, WM_DEFERRED_INIT, 0, 0);
 
     SetTimer(g_hMain, TIMER_UI, 200, NULL);
     SetTimer(g_hMain, TIMER_SAVE, 60 * 1000, NULL);
@@ -295,6 +2668,8 @@ int APIENTRY wWinMain(HINSTANCE hInstance, HINSTANCE, LPWSTR, int nCmdShow) {
     }
 
     if (g_hook) UnhookWindowsHookEx(g_hook);
+    ApplyLoadedState();
+    WorkStop();
     return (int)msg.wParam;
 }
 
@@ -322,12 +2697,32 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
         }
         // No custom handling for maximize; window doesn't have maximize box
         return DefWindowProcW(hWnd, msg, wParam, lParam);
+    case WM_PAINT:
+        if (g_startupPaintMs < 0.0) {
+            g_startupPaintMs = StartupElapsedMs();
+            ReportStartup();
+        }
+        return DefWindowProcW(hWnd, msg, wParam, lParam);
+    case WM_DEFERRED_INIT:
     case WM_DPICHANGED:
     case WM_DISPLAYCHANGE:
         EnumerateMonitors();
         break;
+    case WM_STATE_LOADED:
+        ApplyLoadedState();
+        ReportStartup();
+        UpdateUI(hWnd);
+        if (g_closePending) PostMessageW(hWnd, WM_CLOSE, 0, 0);
+        break;
     case WM_TIMER:
-        if (wParam == TIMER_UI) UpdateUI(hWnd);
+        if (wParam == TIMER_UI) {
+            RollupAdvance(); DwellTick(); FittsDrain(); MonitorsTick(); TitlesTick(); TremorDrain();
+            if (g_stateLoaded) AlertsTick(hWnd);
+#ifndef MPT_MINIMAL
+            GraphTick(); HeatTick();
+#endif
+            UpdateUI(hWnd); HostPublish(); TrayTick(hWnd);
+        }
         else if (wParam == TIMER_SAVE) SaveState();
         break;
     case WM_TRAYICON:
@@ -345,6 +2740,27 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
                 case 4001: RestoreFromTray(hWnd); break;
                 case 4002: g_running = !g_running; break;
                 case 4003: ResetCounters(); break;
+                case 4005: {
+                    RollupAdvance();
+                    EnterCriticalSection(&g_workLock);
+                    g_exportSnapshot.rollupHour = g_rollupHour;
+                    g_exportSnapshot.todayKey = g_todayKey;
+                    g_exportSnapshot.todayMM = g_todayMM;
+                    for (UINT i = 0; i < ROLLUP_HOURS; ++i) g_exportSnapshot.hourMM[i] = g_hourMM[i];
+#ifndef MPT_MINIMAL
+                    g_exportSnapshot.tremor = g_tremorEnabled;
+                    g_exportSnapshot.tremorMinute = g_tremorMinute;
+                    if (g_tremorEnabled)
+                        for (UINT i = 0; i < TREMOR_MINUTES; ++i) g_exportSnapshot.tremorMinutes[i] = g_tremorMinutes[i];
+#endif
+                    LeaveCriticalSection(&g_workLock);
+                    WorkSubmit(WORK_EXPORT);
+                    break;
+                }
+#ifndef MPT_MINIMAL
+                case 4006: GraphToggle(); break;
+                case 4007: HeatToggle(); break;
+#endif
                 case 4004: SendMessageW(hWnd, WM_CLOSE, 0, 0); break;
                 }
                 UpdateUI(hWnd);
@@ -352,6 +2768,13 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
         }
         break;
     case WM_CLOSE:
+        if (!g_stateLoaded) {
+            // Waiting for the worker here would block the hook's thread, and
+            // with it the pointer; close once WM_STATE_LOADED arrives instead.
+            g_closePending = true;
+            ShowWindow(hWnd, SW_HIDE);
+            break;
+        }
         SaveState(); // ensure INI is written before closing
         DestroyWindow(hWnd);
         break;
@@ -359,6 +2782,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
         KillTimer(hWnd, TIMER_UI);
         KillTimer(hWnd, TIMER_SAVE);
         if (g_inTray) EnsureTrayIcon(hWnd, false);
+        TrayIconFree();
         PostQuitMessage(0);
         break;
     default:
@@ -368,5 +2792,24 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
 }
 
 // Helpers
-void ResetCounters() { g_totalMM = 0.0; g_hasLast = false; }
+void ResetCounters() {
+    g_totalMM = 0.0; g_rolledMM = 0.0; g_hasLast = false;
+    g_injectedMM = 0.0;
+    g_synthRun.steps = 0;
+#ifndef MPT_MINIMAL
+    for (UINT i = 0; i < g_monitorUsageCount; ++i)
+        g_monitorUsage[i].mm = g_monitorUsage[i].ms = g_monitorUsage[i].crossings = 0.0;
+    g_titleCount = 0;
+    g_titleRolledMM = 0.0;
+    for (UINT i = 0; i < g_zoneCount; ++i) g_zones[i].mm = g_zones[i].ms = 0.0;
+    for (UINT i = 0; i < HeatOffset(DWELL_LEVELS); ++i) g_dwellHeat[i] = 0.0;
+    g_appCount = 0;
+    g_dwellActive = false;
+    g_lastDwell = DwellEpisode{};
+    g_fitts.armed = false;
+    g_fittsTail = g_fittsHead;
+    g_fittsAppCount = 0;
+    for (UINT h = 0; h < 24; ++h) g_fittsHours[h] = FittsStats{};
+#endif
+}
 